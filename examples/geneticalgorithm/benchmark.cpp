@@ -0,0 +1,414 @@
+#include <geneticalgorithm.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#define BENCHMARK_RUN_COUNT 5
+#define BENCHMARK_MAX_GENERATION 100000
+#define BENCHMARK_TIME_BUDGET 2.0
+#define BENCHMARK_ELITE 0.1
+#define ONEMAX_SIZE 256
+#define TRAP_SIZE 32
+#define TRAP_ORDER 4
+#define RASTRIGIN_SIZE 10
+#define ROSENBROCK_SIZE 5
+#define KNAPSACK_SIZE 64
+#define KNAPSACK_MAX_WEIGHT 32
+
+using Headless::Logic::GA::Random;
+typedef std::chrono::steady_clock Clock;
+
+// Genomes -------------------------------------------------------------------
+template <unsigned int N> struct Bits {
+    static const unsigned int size = N;
+    unsigned char gene[N];
+};
+
+template <unsigned int N> struct Reals {
+    static const unsigned int size = N;
+    double gene[N];
+};
+
+// Problems ------------------------------------------------------------------
+// A problem defines its genome, its name, the error to reach, how to draw
+// a genome and its error (0 at the optimum). Real-valued problems also
+// define their domain, for mutation.
+
+/**
+ * Count of ones.
+ */
+class OneMax {
+    public:
+        typedef Bits<ONEMAX_SIZE> Genome;
+        const char *name() const { return "onemax"; }
+        double target() const { return 0.0; }
+        void initialize(Genome &genome, Random &random) const;
+        double evaluate(const Genome &genome) const;
+};
+
+void OneMax::initialize(Genome &genome, Random &random) const {
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        genome.gene[i] = random.below(2);
+    }
+}
+
+double OneMax::evaluate(const Genome &genome) const {
+    unsigned int ones = 0;
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        ones += genome.gene[i];
+    }
+    return Genome::size - ones;
+}
+
+/**
+ * Concatenated deceptive traps: each block of TRAP_ORDER bits pays the most
+ * when all set, but its slope leads to all cleared.
+ */
+class Trap {
+    public:
+        typedef Bits<TRAP_SIZE> Genome;
+        const char *name() const { return "trap"; }
+        double target() const { return 0.0; }
+        void initialize(Genome &genome, Random &random) const;
+        double evaluate(const Genome &genome) const;
+};
+
+void Trap::initialize(Genome &genome, Random &random) const {
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        genome.gene[i] = random.below(2);
+    }
+}
+
+double Trap::evaluate(const Genome &genome) const {
+    double error = 0.0;
+    for(unsigned int i = 0; i < Genome::size; i += TRAP_ORDER) {
+        unsigned int ones = 0;
+        for(unsigned int j = 0; j < TRAP_ORDER; ++j) {
+            ones += genome.gene[i + j];
+        }
+        error += ones == TRAP_ORDER ? 0 : ones + 1;
+    }
+    return error;
+}
+
+/**
+ * Rastrigin function, many regularly spaced local minima.
+ */
+class Rastrigin {
+    public:
+        typedef Reals<RASTRIGIN_SIZE> Genome;
+        const char *name() const { return "rastrigin"; }
+        double target() const { return 1e-2; }
+        double lower() const { return -5.12; }
+        double upper() const { return 5.12; }
+        void initialize(Genome &genome, Random &random) const;
+        double evaluate(const Genome &genome) const;
+};
+
+void Rastrigin::initialize(Genome &genome, Random &random) const {
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        genome.gene[i] = lower() + random.uniform() * (upper() - lower());
+    }
+}
+
+double Rastrigin::evaluate(const Genome &genome) const {
+    double error = 10.0 * Genome::size;
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        double x = genome.gene[i];
+        error += x * x - 10.0 * std::cos(2.0 * M_PI * x);
+    }
+    return error;
+}
+
+/**
+ * Rosenbrock function, a narrow curved valley.
+ */
+class Rosenbrock {
+    public:
+        typedef Reals<ROSENBROCK_SIZE> Genome;
+        const char *name() const { return "rosenbrock"; }
+        double target() const { return 1e-2; }
+        double lower() const { return -2.048; }
+        double upper() const { return 2.048; }
+        void initialize(Genome &genome, Random &random) const;
+        double evaluate(const Genome &genome) const;
+};
+
+void Rosenbrock::initialize(Genome &genome, Random &random) const {
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        genome.gene[i] = lower() + random.uniform() * (upper() - lower());
+    }
+}
+
+double Rosenbrock::evaluate(const Genome &genome) const {
+    double error = 0.0;
+    for(unsigned int i = 0; i + 1 < Genome::size; ++i) {
+        double x = genome.gene[i];
+        double y = genome.gene[i + 1];
+        error += 100.0 * (y - x * x) * (y - x * x) + (1.0 - x) * (1.0 - x);
+    }
+    return error;
+}
+
+/**
+ * 0/1 knapsack with a fixed random instance. The error is the value gap to
+ * the optimum (found by dynamic programming), relative to it. Overweight
+ * solutions are penalized by their excess, beyond any value it could bring.
+ */
+class Knapsack {
+    public:
+        typedef Bits<KNAPSACK_SIZE> Genome;
+        Knapsack();
+        const char *name() const { return "knapsack"; }
+        double target() const { return 0.0; }
+        void initialize(Genome &genome, Random &random) const;
+        double evaluate(const Genome &genome) const;
+    private:
+        unsigned int _weight[KNAPSACK_SIZE];
+        unsigned int _value[KNAPSACK_SIZE];
+        unsigned int _capacity;
+        unsigned int _optimum;
+};
+
+Knapsack::Knapsack() : _capacity(0) {
+    std::mt19937 mt(KNAPSACK_SIZE);
+    std::uniform_int_distribution<unsigned int> draw(1, KNAPSACK_MAX_WEIGHT);
+    for(unsigned int i = 0; i < KNAPSACK_SIZE; ++i) {
+        _weight[i] = draw(mt);
+        _value[i] = draw(mt);
+        _capacity += _weight[i];
+    }
+    _capacity /= 2;
+    std::vector<unsigned int> best(_capacity + 1, 0);
+    for(unsigned int i = 0; i < KNAPSACK_SIZE; ++i) {
+        for(unsigned int w = _capacity; w >= _weight[i]; --w) {
+            unsigned int value = best[w - _weight[i]] + _value[i];
+            best[w] = value > best[w] ? value : best[w];
+        }
+    }
+    _optimum = best[_capacity];
+}
+
+void Knapsack::initialize(Genome &genome, Random &random) const {
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        genome.gene[i] = random.below(2);
+    }
+}
+
+double Knapsack::evaluate(const Genome &genome) const {
+    unsigned int weight = 0;
+    unsigned int value = 0;
+    for(unsigned int i = 0; i < Genome::size; ++i) {
+        weight += genome.gene[i] * _weight[i];
+        value += genome.gene[i] * _value[i];
+    }
+    double excess = weight > _capacity ? (weight - _capacity) * KNAPSACK_MAX_WEIGHT : 0.0;
+    return (static_cast<double>(_optimum) - value + excess) / _optimum;
+}
+
+// Environment ---------------------------------------------------------------
+template <typename P> class Environment {
+    public:
+        typedef typename P::Genome Genome;
+        Environment(const P &problem) : _problem(problem) {}
+        void reserve(Genome**& buffer, unsigned int size, Random &random);
+        void release(Genome** buffer, unsigned int size);
+        double evaluate(const Genome *genome) { return _problem.evaluate(*genome); }
+        Genome *clone(const Genome *genome) { return new Genome(*genome); }
+    private:
+        const P &_problem;
+};
+
+template <typename P> void Environment<P>::reserve(Genome**& buffer, unsigned int size,
+        Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Genome();
+        _problem.initialize(*buffer[i], random);
+    }
+}
+
+template <typename P> void Environment<P>::release(Genome** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+// Mutators ------------------------------------------------------------------
+/**
+ * Uniform crossover, for any genome.
+ */
+template <typename G> class Crossover {
+    public:
+        double threshold() { return 0.7; }
+        void mutate(G** parents, unsigned int, G* offspring, Random &random) {
+            for(unsigned int i = 0; i < G::size; ++i) {
+                offspring->gene[i] = parents[random.below(2)]->gene[i];
+            }
+        }
+};
+
+/**
+ * Bit-flip mutation, one flip expected per genome.
+ */
+template <unsigned int N> class Flip {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Bits<N>** parents, unsigned int, Bits<N>* offspring, Random &random) {
+            *offspring = *parents[0];
+            for(unsigned int i = 0; i < N; ++i) {
+                offspring->gene[i] ^= random.below(N) == 0 ? 1 : 0;
+            }
+        }
+};
+
+/**
+ * Gaussian mutation of one gene, with a step drawn on a log scale of the
+ * domain so that both coarse and fine moves happen.
+ */
+template <typename P> class Gaussian {
+    public:
+        typedef typename P::Genome Genome;
+        Gaussian(const P &problem) : _problem(problem) {}
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Genome** parents, unsigned int, Genome* offspring, Random &random) {
+            *offspring = *parents[0];
+            std::normal_distribution<double> normal(0.0, 1.0);
+            double range = _problem.upper() - _problem.lower();
+            double step = range * std::pow(10.0, -1.0 - 4.0 * random.uniform());
+            double &gene = offspring->gene[random.below(Genome::size)];
+            gene += normal(random) * step;
+            gene = gene < _problem.lower() ? _problem.lower() : gene;
+            gene = gene > _problem.upper() ? _problem.upper() : gene;
+        }
+    private:
+        const P &_problem;
+};
+
+template <typename P> struct Mutation;
+
+template <> struct Mutation<OneMax> {
+    typedef Flip<ONEMAX_SIZE> Type;
+    static Type make(const OneMax &) { return Type(); }
+};
+
+template <> struct Mutation<Trap> {
+    typedef Flip<TRAP_SIZE> Type;
+    static Type make(const Trap &) { return Type(); }
+};
+
+template <> struct Mutation<Knapsack> {
+    typedef Flip<KNAPSACK_SIZE> Type;
+    static Type make(const Knapsack &) { return Type(); }
+};
+
+template <> struct Mutation<Rastrigin> {
+    typedef Gaussian<Rastrigin> Type;
+    static Type make(const Rastrigin &problem) { return Type(problem); }
+};
+
+template <> struct Mutation<Rosenbrock> {
+    typedef Gaussian<Rosenbrock> Type;
+    static Type make(const Rosenbrock &problem) { return Type(problem); }
+};
+
+// Benchmark -----------------------------------------------------------------
+void threads(unsigned int count) {
+#ifdef _OPENMP
+    omp_set_num_threads(count);
+#else
+    (void) count;
+#endif
+}
+
+/**
+ * Run a problem BENCHMARK_RUN_COUNT times for each pool size and thread count.
+ */
+template <typename P> void benchmark(std::ostream &out, const P &problem, std::uint64_t seed,
+        const std::vector<unsigned int> &pools, const std::vector<unsigned int> &teams,
+        bool &first) {
+    typedef typename P::Genome Genome;
+    Environment<P> env(problem);
+    Crossover<Genome> crossover;
+    typename Mutation<P>::Type mutation = Mutation<P>::make(problem);
+
+    for(unsigned int p = 0; p < pools.size(); ++p) {
+        for(unsigned int t = 0; t < teams.size(); ++t) {
+            std::cerr << problem.name() << " / " << pools[p] << " / " << teams[t] << std::endl;
+            threads(teams[t]);
+            unsigned long long evaluations = 0;
+            double seconds = 0.0;
+            unsigned int successes = 0;
+            double targetSeconds = 0.0;
+            unsigned long long targetEvaluations = 0;
+            double error = 0.0;
+            for(unsigned int r = 0; r < BENCHMARK_RUN_COUNT; ++r) {
+                Headless::Logic::GA::Trivial<Genome> engine(pools[p], seed + r);
+                engine.criteria().seconds = BENCHMARK_TIME_BUDGET;
+                Genome *best = nullptr;
+                Clock::time_point start = Clock::now();
+                engine.train(&env, BENCHMARK_MAX_GENERATION, problem.target(), BENCHMARK_ELITE,
+                        &best, 1, &crossover, &mutation);
+                double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                double score = env.evaluate(best);
+                env.release(&best, 1);
+
+                evaluations += engine.evaluations();
+                seconds += elapsed;
+                error += score;
+                if(score <= problem.target()) {
+                    ++successes;
+                    targetSeconds += elapsed;
+                    targetEvaluations += engine.evaluations();
+                }
+            }
+            if(!first) {
+                out << ",\n";
+            }
+            first = false;
+            double found = successes > 0 ? successes : 1.0;
+            out << "    {\"problem\": \"" << problem.name()
+                << "\", \"pool\": " << pools[p]
+                << ", \"threads\": " << teams[t]
+                << ", \"runs\": " << BENCHMARK_RUN_COUNT
+                << ",\n      \"evaluationsPerSecond\": " << (seconds > 0.0 ? evaluations / seconds : 0.0)
+                << ", \"successRate\": " << static_cast<double>(successes) / BENCHMARK_RUN_COUNT
+                << ", \"meanError\": " << error / BENCHMARK_RUN_COUNT
+                << ",\n      \"timeToTarget\": " << targetSeconds / found
+                << ", \"evaluationsToTarget\": " << targetEvaluations / found
+                << "}";
+        }
+    }
+}
+
+/**
+ * Usage: benchmark [seed]
+ * Runs are stopped at the target error or after BENCHMARK_TIME_BUDGET
+ * seconds. Time (in seconds) and evaluations to target are averaged over
+ * successful runs only, and are 0 without any.
+ */
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::random_device()();
+
+    std::vector<unsigned int> pools = { 64, 256, 1024 };
+    std::vector<unsigned int> teams;
+    unsigned int available = Headless::Logic::GA::Parallel::count();
+    for(unsigned int count = 1; count < available; count *= 2) {
+        teams.push_back(count);
+    }
+    teams.push_back(available);
+
+    std::cout << "{\n  \"seed\": " << seed << ",\n  \"runs\": [\n";
+    bool first = true;
+    benchmark(std::cout, OneMax(), seed, pools, teams, first);
+    benchmark(std::cout, Trap(), seed, pools, teams, first);
+    benchmark(std::cout, Rastrigin(), seed, pools, teams, first);
+    benchmark(std::cout, Rosenbrock(), seed, pools, teams, first);
+    benchmark(std::cout, Knapsack(), seed, pools, teams, first);
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
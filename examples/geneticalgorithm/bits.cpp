@@ -0,0 +1,180 @@
+#include <geneticalgorithmbits.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#define GENOME_SIZE 1000
+#define POOL_SIZE 128
+#define MAX_GENERATION 100000
+#define MEMO_SIZE 4096
+#define OPERATOR_CHECKS 2000
+
+using Headless::Logic::GA::Changes;
+using Headless::Logic::GA::Random;
+
+typedef Headless::Logic::GA::Bits<GENOME_SIZE> Genome;
+
+// Bit-packed genomes on OneMax (maximize the number of set bits). The size
+// is not a multiple of 64, so that padding bits matter. Operators must report
+// exact changes and keep the padding clear, bit flips must cope with edge
+// rates, delta evaluation must match full evaluation, and training must reach
+// the optimum.
+
+// Environment ---------------------------------------------------------------
+class Environment {
+    public:
+        Environment() : _deltas(0), _errors(0) {}
+        void reserve(Genome**&, unsigned int, Random &);
+        void release(Genome**, unsigned int);
+        double evaluate(const Genome *);
+        double evaluateDelta(const Genome *, const Genome *, double, const Changes &);
+        Genome *clone(const Genome *);
+        unsigned long long deltas() const { return _deltas.load(); }
+        unsigned long long errors() const { return _errors.load(); }
+    private:
+        std::atomic<unsigned long long> _deltas;
+        std::atomic<unsigned long long> _errors;
+};
+
+void Environment::reserve(Genome**& buffer, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Genome();
+        buffer[i]->randomize(random);
+    }
+}
+
+void Environment::release(Genome** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+double Environment::evaluate(const Genome *genome) {
+    return GENOME_SIZE - genome->count();
+}
+
+double Environment::evaluateDelta(const Genome *offspring, const Genome *,
+        double parentScore, const Changes &changes) {
+    double score = parentScore;
+    for(unsigned int i = 0; i < changes.size(); ++i) {
+        score += offspring->get(changes[i]) ? -1.0 : 1.0;
+    }
+    ++_deltas;
+    if(score != evaluate(offspring)) {
+        ++_errors;
+    }
+    return score;
+}
+
+Genome *Environment::clone(const Genome *genome) {
+    return new Genome(*genome);
+}
+
+/**
+ * Replay reported changes on the parent.
+ * @return 'true' if they give the offspring, or if changes are unknown.
+ */
+bool replay(const Genome &parent, const Genome &offspring, const Changes &changes) {
+    if(!changes.known()) {
+        return true;
+    }
+    Genome replayed = parent;
+    for(unsigned int i = 0; i < changes.size(); ++i) {
+        replayed.flip(changes[i]);
+    }
+    return replayed == offspring;
+}
+
+/**
+ * @return 'true' if the bits past the genome size are clear.
+ */
+bool padded(const Genome &genome) {
+    const std::uint64_t *data = genome.data();
+    for(unsigned int i = GENOME_SIZE; i < Genome::words * 64; ++i) {
+        if((data[i / 64] >> (i % 64)) & 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Apply a bit flip with the given rate.
+ * @return Number of flipped bits, or 0 if reported changes are wrong.
+ */
+unsigned int flips(double rate, Random &random) {
+    Headless::Logic::GA::BitFlip<GENOME_SIZE> flip(rate);
+    Genome parent;
+    Genome offspring;
+    parent.randomize(random);
+    Genome *parents[1] = { &parent };
+    Changes changes;
+    flip.mutate(parents, 1, &offspring, random, changes);
+    return replay(parent, offspring, changes) ? parent.distance(offspring) : 0;
+}
+
+/**
+ * Apply an operator to random parents and check the result.
+ */
+template <typename M> bool check(M &mutator, Random &random) {
+    Genome first;
+    Genome second;
+    Genome offspring;
+    first.randomize(random);
+    second.randomize(random);
+    Genome *parents[2] = { &first, &second };
+    Changes changes;
+    mutator.mutate(parents, mutator.arity(), &offspring, random, changes);
+    return replay(first, offspring, changes) && padded(offspring);
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: bits [seed]
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 9;
+
+    // - Operators.
+    Headless::Logic::GA::UniformCrossover<GENOME_SIZE> uniform;
+    Headless::Logic::GA::OnePointCrossover<GENOME_SIZE> onePoint;
+    Headless::Logic::GA::TwoPointCrossover<GENOME_SIZE> twoPoint;
+    Headless::Logic::GA::BitFlip<GENOME_SIZE> flip(3.0 / GENOME_SIZE);
+    unsigned int wrong = 0;
+    for(unsigned int i = 0; i < OPERATOR_CHECKS; ++i) {
+        Random random(seed, 0, i);
+        wrong += check(uniform, random) ? 0 : 1;
+        wrong += check(onePoint, random) ? 0 : 1;
+        wrong += check(twoPoint, random) ? 0 : 1;
+        wrong += check(flip, random) ? 0 : 1;
+    }
+    std::cout << "Operator checks : " << 4 * OPERATOR_CHECKS << " (" << wrong << " wrong)" << std::endl;
+
+    // - Edge rates: none or negative flip the single forced bit, one or
+    // more flip everything.
+    Random random(seed, 1, 0);
+    bool edges = 1 == flips(0.0, random) && 1 == flips(-0.5, random)
+        && 1 == flips(std::nan(""), random) && GENOME_SIZE == flips(1.0, random)
+        && GENOME_SIZE == flips(2.0, random);
+    std::cout << "Edge rates : " << (edges ? "OK" : "NOK") << std::endl;
+
+    // - Training, with delta evaluation of bit flips.
+    Environment env;
+    Headless::Logic::GA::BitFlip<GENOME_SIZE> mutate;
+    Headless::Logic::GA::Trivial<Genome,
+        Headless::Logic::GA::Memo<Genome, Headless::Logic::GA::BitsHash<GENOME_SIZE>, MEMO_SIZE> >
+        engine(POOL_SIZE, seed);
+    Genome *store[1];
+    int result = engine.train(&env, MAX_GENERATION, 0.0, 0.1, store, 1, &uniform, &mutate);
+
+    unsigned int ones = result > 0 ? store[0]->count() : 0;
+    std::cout << "Generations " << engine.generation() << std::endl;
+    std::cout << "Evaluations " << engine.evaluations() << std::endl;
+    std::cout << "Deltas " << env.deltas() << " (" << env.errors() << " wrong)" << std::endl;
+    std::cout << "Set bits " << ones << "/" << GENOME_SIZE << std::endl;
+
+    if(result > 0) {
+        delete store[0];
+    }
+
+    return 0 == wrong && edges && 0 == env.errors() && env.deltas() > 0 && GENOME_SIZE == ones ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include <geneticalgorithmcontiguous.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <omp.h>
+
+#define GENOME_SIZE 48
+#define GENE_RANGE 32
+#define POOL_SIZE 256
+#define MAX_GENERATION 5000
+#define MIN_ERROR 0.5
+#define RESULT_COUNT 8
+
+using Headless::Logic::GA::Random;
+
+// Contiguous engine: candidates stored by value. Training must reach the
+// goal with the same results whatever the number of threads, and a training
+// without generation must still rank the initial pool. Evaluating a column
+// layout of the pool must give the same results as evaluating candidates.
+
+// Candidate -----------------------------------------------------------------
+struct Candidate {
+    int gene[GENOME_SIZE];
+};
+
+// Columns -------------------------------------------------------------------
+// One array per gene.
+class Columns {
+    public:
+        static const bool enabled = true;
+        Columns() : _gene(nullptr), _count(0) {}
+        ~Columns() { delete []_gene; }
+        void reserve(unsigned int count) {
+            _gene = new int[GENOME_SIZE * count];
+            _count = count;
+        }
+        void store(unsigned int index, const Candidate &candidate) {
+            for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+                _gene[j * _count + index] = candidate.gene[j];
+            }
+        }
+        const int *column(unsigned int gene) const { return _gene + gene * _count; }
+    private:
+        Columns(const Columns &);
+        Columns &operator=(const Columns &);
+        int *_gene;
+        unsigned int _count;
+};
+
+// Environment ---------------------------------------------------------------
+class Environment {
+    public:
+        Environment();
+        void initialize(Candidate*, unsigned int, Random &);
+        double evaluate(const Candidate *);
+        void evaluate(const Columns &, unsigned int, unsigned int, double *);
+    private:
+        int _goal[GENOME_SIZE];
+};
+
+Environment::Environment() {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        _goal[i] = (i * 11) % GENE_RANGE;
+    }
+}
+
+void Environment::initialize(Candidate* pool, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            pool[i].gene[j] = random.below(GENE_RANGE);
+        }
+    }
+}
+
+double Environment::evaluate(const Candidate *candidate) {
+    double error = 0.0;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        error += std::abs(candidate->gene[i] - _goal[i]);
+    }
+    return error;
+}
+
+void Environment::evaluate(const Columns &columns, unsigned int first, unsigned int count,
+        double *scores) {
+    for(unsigned int i = 0; i < count; ++i) {
+        scores[i] = 0.0;
+    }
+    // Gene by gene, across candidates.
+    for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+        const int *gene = columns.column(j) + first;
+        for(unsigned int i = 0; i < count; ++i) {
+            scores[i] += std::abs(gene[i] - _goal[j]);
+        }
+    }
+}
+
+// Crossover -----------------------------------------------------------------
+class Crossover {
+    public:
+        double threshold() { return 0.5; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void Crossover::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    unsigned int cut = 1 + random.below(GENOME_SIZE - 1);
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        offspring->gene[i] = parents[i < cut ? 0 : 1]->gene[i];
+    }
+}
+
+// Point Mutator -------------------------------------------------------------
+class PointMutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void PointMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    *offspring = *parents[0];
+    unsigned int gene = random.below(GENOME_SIZE);
+    offspring->gene[gene] += random.below(2) == 1 ? 1 : -1;
+}
+
+/**
+ * Train an engine with the given number of threads.
+ * @param <L> Column layout.
+ * @return 'true' if results are sorted, match their scores and reach the
+ * specified error.
+ */
+template <typename L> bool train(Environment &env, unsigned int threads, unsigned int maxGen,
+        double expected, Candidate *results, unsigned int &count) {
+    omp_set_num_threads(threads);
+    Headless::Logic::GA::Contiguous<Candidate, Headless::Logic::GA::Truncation, L> engine(POOL_SIZE, 7);
+    Crossover crossover;
+    PointMutator mutate;
+    unsigned int elite = engine.train(&env, maxGen, MIN_ERROR, 0.1, &crossover, &mutate);
+    bool valid = engine.score(0) <= expected;
+    for(unsigned int i = 0; i < elite; ++i) {
+        valid = valid && engine.score(i) == env.evaluate(engine.results() + i);
+        valid = valid && (0 == i || engine.score(i - 1) <= engine.score(i));
+    }
+    count = engine.move(results, RESULT_COUNT);
+    std::cout << threads << " thread(s), " << maxGen << " generation(s) max"
+        << (L::enabled ? ", columns" : "") << " : best "
+        << engine.score(0) << (valid ? "" : " (invalid)") << std::endl;
+    return valid;
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: contiguous
+int main(int, char **) {
+    Environment env;
+    Candidate single[RESULT_COUNT];
+    Candidate multiple[RESULT_COUNT];
+    Candidate initial[RESULT_COUNT];
+    Candidate columns[RESULT_COUNT];
+    unsigned int singleCount;
+    unsigned int multipleCount;
+    unsigned int initialCount;
+    unsigned int columnsCount;
+
+    using Headless::Logic::GA::NoColumns;
+    bool valid = train<NoColumns>(env, 1, MAX_GENERATION, 0.0, single, singleCount);
+    valid = train<NoColumns>(env, 4, MAX_GENERATION, 0.0, multiple, multipleCount) && valid;
+    valid = train<NoColumns>(env, 4, 0, GENOME_SIZE * GENE_RANGE, initial, initialCount) && valid;
+    valid = train<Columns>(env, 4, MAX_GENERATION, 0.0, columns, columnsCount) && valid;
+
+    // Same results whatever the number of threads, and the layout.
+    bool same = singleCount == multipleCount;
+    bool layout = singleCount == columnsCount;
+    for(unsigned int i = 0; i < singleCount; ++i) {
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            same = same && single[i].gene[j] == multiple[i].gene[j];
+            layout = layout && single[i].gene[j] == columns[i].gene[j];
+        }
+    }
+    std::cout << "Thread count independent : " << (same ? "yes" : "no") << std::endl;
+    std::cout << "Layout independent : " << (layout ? "yes" : "no") << std::endl;
+
+    return valid && same && layout && RESULT_COUNT == initialCount ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include <geneticalgorithmislands.hpp>
+#include <cstdlib>
+#include <iostream>
+
+#define GENOME_SIZE 48
+#define GENE_RANGE 32
+#define ISLAND_COUNT 4
+#define POOL_SIZE 64
+#define MAX_GENERATION 5000
+#define MIN_ERROR 0.5
+#define RESULT_COUNT 8
+
+using Headless::Logic::GA::Random;
+
+// Island model: independent pools exchanging their best candidates along
+// a ring. Training must reach the goal, and results must be the best of all
+// islands, whatever the number of threads actually running them (migration
+// itself depends on scheduling).
+
+// Candidate -----------------------------------------------------------------
+struct Candidate {
+    int gene[GENOME_SIZE];
+};
+
+// Environment ---------------------------------------------------------------
+// 'reserve', 'release' and 'clone' are called concurrently by islands.
+class Environment {
+    public:
+        Environment();
+        void reserve(Candidate**&, unsigned int, Random &);
+        void release(Candidate**, unsigned int);
+        double evaluate(const Candidate *);
+        Candidate *clone(const Candidate *);
+    private:
+        int _goal[GENOME_SIZE];
+};
+
+Environment::Environment() {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        _goal[i] = (i * 11) % GENE_RANGE;
+    }
+}
+
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Candidate();
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            buffer[i]->gene[j] = random.below(GENE_RANGE);
+        }
+    }
+}
+
+void Environment::release(Candidate** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+double Environment::evaluate(const Candidate *candidate) {
+    double error = 0.0;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        error += std::abs(candidate->gene[i] - _goal[i]);
+    }
+    return error;
+}
+
+Candidate *Environment::clone(const Candidate *candidate) {
+    return new Candidate(*candidate);
+}
+
+// Crossover -----------------------------------------------------------------
+class Crossover {
+    public:
+        double threshold() { return 0.5; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void Crossover::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    unsigned int cut = 1 + random.below(GENOME_SIZE - 1);
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        offspring->gene[i] = parents[i < cut ? 0 : 1]->gene[i];
+    }
+}
+
+// Point Mutator -------------------------------------------------------------
+class PointMutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void PointMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    *offspring = *parents[0];
+    unsigned int gene = random.below(GENOME_SIZE);
+    offspring->gene[gene] += random.below(2) == 1 ? 1 : -1;
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: islands [seed]
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 7;
+    Headless::Logic::GA::Islands<Candidate> engine(ISLAND_COUNT, POOL_SIZE, seed);
+    engine.migration().topology = Headless::Logic::GA::Migration::RING;
+    engine.migration().interval = 5;
+    engine.migration().count = 2;
+
+    Environment env;
+    Crossover crossover;
+    PointMutator mutate;
+    Candidate **store = new Candidate*[RESULT_COUNT];
+
+    int result = engine.train(&env, MAX_GENERATION, MIN_ERROR, 0.1,
+            store, RESULT_COUNT, &crossover, &mutate);
+
+    std::cout << "Seed " << seed << std::endl;
+    unsigned long long immigrants = 0;
+    double islandBest = -1.0;
+    bool evaluated = true;
+    for(unsigned int i = 0; i < engine.size(); ++i) {
+        const Headless::Logic::GA::IslandStatistics &statistics = engine.statistics(i);
+        std::cout << "Island " << i << " : " << statistics.generations << " generations, best "
+            << statistics.best << ", " << statistics.emigrants << " emigrants, "
+            << statistics.immigrants << " immigrants" << std::endl;
+        immigrants += statistics.immigrants;
+        islandBest = 0 == i || statistics.best < islandBest ? statistics.best : islandBest;
+        evaluated = evaluated && statistics.generations > 0;
+    }
+    std::cout << "Immigrants " << immigrants << std::endl;
+
+    // Results are the best over all islands, sorted.
+    bool sorted = true;
+    for(int i = 1; i < result; ++i) {
+        sorted = sorted && env.evaluate(store[i - 1]) <= env.evaluate(store[i]);
+    }
+    double best = result > 0 ? env.evaluate(store[0]) : -1.0;
+    std::cout << "Best error " << best << std::endl;
+
+    for(unsigned int i = 0; i < static_cast<unsigned int>(result); ++i) {
+        delete store[i];
+    }
+    delete[] store;
+
+    return 0 == best && best == islandBest && sorted && evaluated ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include <geneticalgorithmnovelty.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#define POOL_SIZE 200
+#define MAX_GENERATION 150
+#define RESULT_COUNT 100
+#define ZONE_SIZE 100.0
+#define GRID_SIZE 10
+#define MIN_COVERAGE_RATIO 3
+
+using Headless::Logic::GA::Random;
+
+// Novelty search on a plane: a candidate is a point and its behaviour is its
+// position. Driven by its objective, a pool gathers around the goal; driven
+// by novelty, it spreads over the plane. Results of the novelty run must
+// cover several times as many cells of a grid as the ones of the objective
+// run.
+
+// Candidate and behaviour ---------------------------------------------------
+struct Position {
+    double x;
+    double y;
+};
+
+struct Candidate {
+    Position position;
+};
+
+// Region --------------------------------------------------------------------
+class Region {
+    public:
+        Region() : _x(0.0), _y(0.0), _size(0.0) {}
+        Region(double x, double y, double size) : _x(x), _y(y), _size(size) {}
+        unsigned int dimension() const { return 4; }
+        const Region *divide() const;
+        bool contains(const Position &position) const {
+            return position.x >= _x && position.x <= _x + _size
+                && position.y >= _y && position.y <= _y + _size;
+        }
+        double x() const { return _x; }
+        double y() const { return _y; }
+        double size() const { return _size; }
+    private:
+        double _x;
+        double _y;
+        double _size;
+};
+
+const Region *Region::divide() const {
+    Region *regions = new Region[4];
+    double half = _size / 2.0;
+    regions[0] = Region(_x, _y, half);
+    regions[1] = Region(_x + half, _y, half);
+    regions[2] = Region(_x + half, _y + half, half);
+    regions[3] = Region(_x, _y + half, half);
+    return regions;
+}
+
+// Ball ----------------------------------------------------------------------
+class Ball {
+    public:
+        Ball() : _radius(0.0) {}
+        void set(const Position &center, double radius) {
+            _center = center;
+            _radius = radius;
+        }
+        bool contains(const Position &position) const {
+            return distance(_center, position) <= _radius;
+        }
+        int contains(const Region &region) const;
+        double distance(const Position &a, const Position &b) const {
+            return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+        }
+    private:
+        Position _center;
+        double _radius;
+};
+
+int Ball::contains(const Region &region) const {
+    // Nearest and farthest points of the region.
+    double nearX = std::max(region.x(), std::min(_center.x, region.x() + region.size()));
+    double nearY = std::max(region.y(), std::min(_center.y, region.y() + region.size()));
+    Position nearest = { nearX, nearY };
+    if(distance(_center, nearest) > _radius) {
+        return -1;
+    }
+    double farX = _center.x < region.x() + region.size() / 2.0 ? region.x() + region.size() : region.x();
+    double farY = _center.y < region.y() + region.size() / 2.0 ? region.y() + region.size() : region.y();
+    Position farthest = { farX, farY };
+    return distance(_center, farthest) <= _radius ? 1 : 0;
+}
+
+// Environment ---------------------------------------------------------------
+class Environment {
+    public:
+        Environment(bool objective) : _objective(objective) {}
+        void reserve(Candidate**&, unsigned int, Random &);
+        void release(Candidate**, unsigned int);
+        double evaluate(const Candidate *);
+        void describe(const Candidate *candidate, Position &behaviour) {
+            behaviour = candidate->position;
+        }
+        Candidate *clone(const Candidate *);
+    private:
+        bool _objective;
+};
+
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
+    // Everybody starts in the same corner.
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Candidate();
+        buffer[i]->position.x = random.uniform();
+        buffer[i]->position.y = random.uniform();
+    }
+}
+
+void Environment::release(Candidate** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+double Environment::evaluate(const Candidate *candidate) {
+    if(!_objective) {
+        return 0.0;
+    }
+    double dx = candidate->position.x - 20.0;
+    double dy = candidate->position.y - 20.0;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+Candidate *Environment::clone(const Candidate *candidate) {
+    return new Candidate(*candidate);
+}
+
+// Step Mutator --------------------------------------------------------------
+class StepMutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void StepMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    *offspring = *parents[0];
+    double x = offspring->position.x + (random.uniform() - 0.5) * 4.0;
+    double y = offspring->position.y + (random.uniform() - 0.5) * 4.0;
+    offspring->position.x = x < 0.0 ? 0.0 : (x > ZONE_SIZE ? ZONE_SIZE : x);
+    offspring->position.y = y < 0.0 ? 0.0 : (y > ZONE_SIZE ? ZONE_SIZE : y);
+}
+
+typedef Headless::Logic::GA::Novelty<Candidate, Position, Region, Ball> Novelty;
+
+/**
+ * Train a pool.
+ * @param weight Novelty weight. 0 for the objective only.
+ * @return Number of grid cells holding results.
+ */
+unsigned int train(double weight) {
+    Headless::Logic::GA::Trivial<Candidate,
+        Headless::Logic::GA::NoMemo,
+        Headless::Logic::GA::Tournament<2>,
+        Headless::Logic::GA::Cascade,
+        Headless::Logic::GA::NullObserver,
+        Headless::Logic::GA::NoSurrogate,
+        Novelty> engine(POOL_SIZE, 7);
+    engine.niching().region() = Region(0.0, 0.0, ZONE_SIZE);
+    engine.niching().weight() = weight;
+    engine.niching().admissions() = 4;
+
+    Environment env(0.0 == weight);
+    StepMutator mutate;
+    Candidate *store[RESULT_COUNT];
+    int result = engine.train(&env, MAX_GENERATION, -1.0, 0.5, store, RESULT_COUNT, &mutate);
+
+    bool cells[GRID_SIZE][GRID_SIZE] = {};
+    unsigned int covered = 0;
+    for(int i = 0; i < result; ++i) {
+        unsigned int x = static_cast<unsigned int>(store[i]->position.x * GRID_SIZE / ZONE_SIZE);
+        unsigned int y = static_cast<unsigned int>(store[i]->position.y * GRID_SIZE / ZONE_SIZE);
+        x = x < GRID_SIZE ? x : GRID_SIZE - 1;
+        y = y < GRID_SIZE ? y : GRID_SIZE - 1;
+        covered += cells[x][y] ? 0 : 1;
+        cells[x][y] = true;
+        delete store[i];
+    }
+    return covered;
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: novelty
+int main(int, char **) {
+    unsigned int objective = train(0.0);
+    unsigned int novelty = train(1.0);
+
+    std::cout << "Objective : " << objective << " cells covered" << std::endl;
+    std::cout << "Novelty : " << novelty << " cells covered" << std::endl;
+
+    return objective > 0 && novelty >= MIN_COVERAGE_RATIO * objective ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+#include <geneticalgorithm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#define GENOME_SIZE 30
+#define POOL_SIZE 200
+#define MAX_GENERATION 3000
+#define MAX_GAP 0.01
+#define FAILING_GENERATION 50
+
+using Headless::Logic::GA::Random;
+
+// Multi-objective engine on ZDT1: minimize f1 = x0 and
+// f2 = g (1 - sqrt(x0 / g)), where g = 1 + 9 mean(x1..x29). The Pareto front
+// is f2 = 1 - sqrt(f1) (g = 1). Results must be mutually non-dominated, close
+// to that front and spread along it.
+// A simulator that fails on some candidates reports NaN objectives. Training
+// must still end, and rank NaN as +infinity.
+
+// Candidate -----------------------------------------------------------------
+struct Candidate {
+    double x[GENOME_SIZE];
+};
+
+// Environment ---------------------------------------------------------------
+class Environment {
+    public:
+        void reserve(Candidate**&, unsigned int, Random &);
+        void release(Candidate**, unsigned int);
+        void evaluate(const Candidate *, double *);
+        Candidate *clone(const Candidate *);
+};
+
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Candidate();
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            buffer[i]->x[j] = random.uniform();
+        }
+    }
+}
+
+void Environment::release(Candidate** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+void Environment::evaluate(const Candidate *candidate, double *objectives) {
+    double sum = 0.0;
+    for(unsigned int j = 1; j < GENOME_SIZE; ++j) {
+        sum += candidate->x[j];
+    }
+    double g = 1.0 + 9.0 * sum / (GENOME_SIZE - 1);
+    objectives[0] = candidate->x[0];
+    objectives[1] = g * (1.0 - std::sqrt(candidate->x[0] / g));
+}
+
+Candidate *Environment::clone(const Candidate *candidate) {
+    return new Candidate(*candidate);
+}
+
+// Failing Environment -------------------------------------------------------
+// Three objectives; one of them is NaN for a third of the candidates, which
+// would make dominance cyclic if NaN were just incomparable.
+class Failing : public Environment {
+    public:
+        void evaluate(const Candidate *, double *);
+};
+
+void Failing::evaluate(const Candidate *candidate, double *objectives) {
+    for(unsigned int k = 0; k < 3; ++k) {
+        objectives[k] = candidate->x[k];
+    }
+    unsigned int failure = static_cast<unsigned int>(candidate->x[3] * 6.0);
+    if(failure < 3) {
+        objectives[failure] = std::nan("");
+    }
+}
+
+// Blend Crossover -----------------------------------------------------------
+class Crossover {
+    public:
+        double threshold() { return 0.9; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void Crossover::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+        double alpha = random.uniform();
+        offspring->x[j] = alpha * parents[0]->x[j] + (1.0 - alpha) * parents[1]->x[j];
+    }
+}
+
+// Uniform Mutator -----------------------------------------------------------
+class Mutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void Mutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    *offspring = *parents[0];
+    for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+        if(random.below(GENOME_SIZE) == 0) {
+            double value = offspring->x[j] + (random.uniform() - 0.5) * 0.2;
+            offspring->x[j] = value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+        }
+    }
+}
+
+// Pareto dominance (minimization), NaN being +infinity.
+bool dominates(const double *a, const double *b, unsigned int count) {
+    bool better = false;
+    for(unsigned int k = 0; k < count; ++k) {
+        double left = std::isnan(a[k]) ? INFINITY : a[k];
+        double right = std::isnan(b[k]) ? INFINITY : b[k];
+        if(left > right) {
+            return false;
+        }
+        better = better || left < right;
+    }
+    return better;
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: pareto [seed]
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 7;
+    Headless::Logic::GA::Pareto<Candidate, 2> engine(POOL_SIZE, seed);
+
+    Environment env;
+    Crossover crossover;
+    Mutator mutate;
+    Candidate **store = new Candidate*[POOL_SIZE];
+
+    int result = engine.train(&env, MAX_GENERATION, store, POOL_SIZE, &crossover, &mutate);
+
+    // Objectives must be the ones of the results.
+    bool consistent = result > 0;
+    double gap = 0.0;
+    double low = 1.0;
+    double high = 0.0;
+    for(int i = 0; i < result; ++i) {
+        const double *objectives = engine.objectives(i);
+        double expected[2];
+        env.evaluate(store[i], expected);
+        consistent = consistent && expected[0] == objectives[0] && expected[1] == objectives[1];
+        gap = std::max(gap, objectives[1] - (1.0 - std::sqrt(objectives[0])));
+        low = std::min(low, objectives[0]);
+        high = std::max(high, objectives[0]);
+    }
+
+    // The front is non-dominated.
+    unsigned int dominated = 0;
+    for(int i = 0; i < result; ++i) {
+        for(int j = 0; j < result; ++j) {
+            dominated += dominates(engine.objectives(j), engine.objectives(i), 2) ? 1 : 0;
+        }
+    }
+
+    std::cout << "Seed " << seed << std::endl;
+    std::cout << "Front size " << result << " (" << dominated << " dominated)" << std::endl;
+    std::cout << "Gap to the true front " << gap << std::endl;
+    std::cout << "Front span " << low << " - " << high << std::endl;
+
+    for(int i = 0; i < result; ++i) {
+        delete store[i];
+    }
+
+    // - Failing simulator.
+    Headless::Logic::GA::Pareto<Candidate, 3> failingEngine(POOL_SIZE, seed);
+    Failing failing;
+    int failingResult = failingEngine.train(&failing, FAILING_GENERATION, store, POOL_SIZE,
+            &crossover, &mutate);
+    unsigned int failingDominated = 0;
+    for(int i = 0; i < failingResult; ++i) {
+        for(int j = 0; j < failingResult; ++j) {
+            failingDominated += dominates(failingEngine.objectives(j), failingEngine.objectives(i), 3) ? 1 : 0;
+        }
+    }
+    std::cout << "With failures, front size " << failingResult << " (" << failingDominated
+        << " dominated)" << std::endl;
+
+    for(int i = 0; i < failingResult; ++i) {
+        delete store[i];
+    }
+    delete[] store;
+
+    return consistent && 0 == dominated && gap < MAX_GAP && low < 0.05 && high > 0.95
+        && failingResult > 0 && 0 == failingDominated ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+#include <geneticalgorithm.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#define GENOME_SIZE 32
+#define GENE_RANGE 64
+#define POOL_SIZE 128
+#define MAX_GENERATION 2000
+#define MIN_ERROR 0.5
+#define RESULT_COUNT 4
+
+using Headless::Logic::GA::Changes;
+using Headless::Logic::GA::Random;
+
+// Offspring pipelines. Evaluating offspring in the breeding loop must give
+// the very same training as evaluating them in a second pass. A longer
+// pipeline (crossover, then mutation, repair and evaluation) must keep delta
+// evaluation exact and reach the goal.
+
+// Candidate -----------------------------------------------------------------
+struct Candidate {
+    int gene[GENOME_SIZE];
+};
+
+// Environment ---------------------------------------------------------------
+class Environment {
+    public:
+        Environment();
+        void reserve(Candidate**&, unsigned int, Random &);
+        void release(Candidate**, unsigned int);
+        double evaluate(const Candidate *);
+        double evaluateDelta(const Candidate *, const Candidate *, double, const Changes &);
+        Candidate *clone(const Candidate *);
+        unsigned long long deltas() const { return _deltas.load(); }
+        unsigned long long errors() const { return _errors.load(); }
+    private:
+        int _goal[GENOME_SIZE];
+        std::atomic<unsigned long long> _deltas;
+        std::atomic<unsigned long long> _errors;
+};
+
+Environment::Environment() : _deltas(0), _errors(0) {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        _goal[i] = (i * 37) % GENE_RANGE;
+    }
+}
+
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Candidate();
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            buffer[i]->gene[j] = random.below(GENE_RANGE);
+        }
+    }
+}
+
+void Environment::release(Candidate** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+double Environment::evaluate(const Candidate *candidate) {
+    double error = 0.0;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        error += std::abs(candidate->gene[i] - _goal[i]);
+    }
+    return error;
+}
+
+double Environment::evaluateDelta(const Candidate *offspring, const Candidate *parent,
+        double parentScore, const Changes &changes) {
+    double error = parentScore;
+    for(unsigned int i = 0; i < changes.size(); ++i) {
+        unsigned int gene = changes[i];
+        error += std::abs(offspring->gene[gene] - _goal[gene]);
+        error -= std::abs(parent->gene[gene] - _goal[gene]);
+    }
+    ++_deltas;
+    if(error != evaluate(offspring)) {
+        ++_errors;
+    }
+    return error;
+}
+
+Candidate *Environment::clone(const Candidate *candidate) {
+    return new Candidate(*candidate);
+}
+
+// Crossover -----------------------------------------------------------------
+class Crossover {
+    public:
+        double threshold() { return 0.5; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &, Changes &);
+};
+
+void Crossover::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random, Changes &changes) {
+    // Genes past the cut that differ from the first parent.
+    unsigned int cut = 1 + random.below(GENOME_SIZE - 1);
+    *offspring = *parents[0];
+    for(unsigned int i = cut; i < GENOME_SIZE; ++i) {
+        if(offspring->gene[i] != parents[1]->gene[i]) {
+            offspring->gene[i] = parents[1]->gene[i];
+            changes.add(i);
+        }
+    }
+}
+
+// Step Mutator --------------------------------------------------------------
+// May leave the gene range: see 'Repair'.
+class StepMutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &, Changes &);
+};
+
+void StepMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random, Changes &changes) {
+    *offspring = *parents[0];
+    unsigned int gene = random.below(GENOME_SIZE);
+    offspring->gene[gene] += random.below(2) == 1 ? 1 : -1;
+    changes.add(gene);
+}
+
+// Repair Stage --------------------------------------------------------------
+// Bring genes back in range. Repaired genes were already changed by the
+// mutator, so there is nothing new to record.
+class Repair {
+    public:
+        template <typename E, typename O> void apply(E*, O &offspring) const {
+            Candidate *genome = offspring.genome();
+            for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+                int gene = genome->gene[i];
+                genome->gene[i] = gene < 0 ? 0 : (gene >= GENE_RANGE ? GENE_RANGE - 1 : gene);
+            }
+        }
+};
+
+typedef Headless::Logic::GA::Trivial<Candidate> Engine;
+
+/**
+ * Train an engine, with or without a pipeline.
+ * @return Best candidate.
+ */
+template <typename... P> Candidate train(Environment &env, unsigned int &generations,
+        unsigned long long &evaluations, const Headless::Logic::GA::Pipeline<P...> *pipeline) {
+    Engine engine(POOL_SIZE, 7);
+    StepMutator mutate;
+    Candidate *store[RESULT_COUNT];
+    int result = nullptr == pipeline
+        ? engine.train(&env, MAX_GENERATION, MIN_ERROR, 0.1, store, RESULT_COUNT, &mutate)
+        : engine.train(&env, *pipeline, MAX_GENERATION, MIN_ERROR, 0.1, store, RESULT_COUNT, &mutate);
+    Candidate best = *store[0];
+    for(int i = 0; i < result; ++i) {
+        delete store[i];
+    }
+    generations = engine.generation();
+    evaluations = engine.evaluations();
+    return best;
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: pipeline
+int main(int, char **) {
+    Environment env;
+
+    // - Fused evaluation changes nothing but when it happens.
+    typedef Headless::Logic::GA::Pipeline<Headless::Logic::GA::Evaluation> Fused;
+    Fused fused;
+    unsigned int plainGenerations;
+    unsigned int fusedGenerations;
+    unsigned long long plainEvaluations;
+    unsigned long long fusedEvaluations;
+    Candidate plain = train(env, plainGenerations, plainEvaluations, static_cast<const Fused *>(nullptr));
+    Candidate best = train(env, fusedGenerations, fusedEvaluations, &fused);
+    bool same = plainGenerations == fusedGenerations && plainEvaluations == fusedEvaluations;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        same = same && plain.gene[i] == best.gene[i];
+    }
+    std::cout << "Plain : " << plainGenerations << " generations, " << plainEvaluations << " evaluations" << std::endl;
+    std::cout << "Fused : " << fusedGenerations << " generations, " << fusedEvaluations << " evaluations" << std::endl;
+    std::cout << "Same training : " << (same ? "yes" : "no") << std::endl;
+
+    // - Crossover, then mutation, repair and evaluation.
+    StepMutator mutate;
+    Crossover crossover;
+    Headless::Logic::GA::Pipeline<Headless::Logic::GA::Mutation<StepMutator*>, Repair,
+        Headless::Logic::GA::Evaluation> pipeline(Headless::Logic::GA::Mutation<StepMutator*>(&mutate, 0.5),
+                Repair(), Headless::Logic::GA::Evaluation());
+    Engine engine(POOL_SIZE, 7);
+    Candidate *store[RESULT_COUNT];
+    int result = engine.train(&env, pipeline, MAX_GENERATION, MIN_ERROR, 0.1,
+            store, RESULT_COUNT, &crossover, &mutate);
+    double error = result > 0 ? env.evaluate(store[0]) : -1.0;
+    std::cout << "Long pipeline : " << engine.generation() << " generations, best error " << error << std::endl;
+    std::cout << "Deltas " << env.deltas() << " (" << env.errors() << " wrong)" << std::endl;
+    for(int i = 0; i < result; ++i) {
+        delete store[i];
+    }
+
+    return same && 0 == error && env.deltas() > 0 && 0 == env.errors() ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#include <geneticalgorithmreal.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <omp.h>
+
+#define DIMENSION 10
+#define DE_POOL_SIZE 50
+#define CMAES_POOL_SIZE 12
+#define MAX_GENERATION 5000
+#define MIN_ERROR 1e-8
+
+// Real-valued engines: differential evolution on a shifted ellipsoid and
+// CMA-ES on the Rosenbrock function, in 10 dimensions. Both must reach the
+// minimum, report the score of their best vector, and give identical
+// results with one or four threads. Populations too small for either engine
+// must be rejected.
+
+// Environments --------------------------------------------------------------
+class Ellipsoid {
+    public:
+        double evaluate(const double *x) {
+            double sum = 0.0;
+            for(unsigned int i = 0; i < DIMENSION; ++i) {
+                double shifted = x[i] - 1.0;
+                sum += (i + 1.0) * shifted * shifted;
+            }
+            return sum;
+        }
+};
+
+class Rosenbrock {
+    public:
+        double evaluate(const double *x) {
+            double sum = 0.0;
+            for(unsigned int i = 0; i + 1 < DIMENSION; ++i) {
+                double a = x[i + 1] - x[i] * x[i];
+                double b = 1.0 - x[i];
+                sum += 100.0 * a * a + b * b;
+            }
+            return sum;
+        }
+};
+
+/**
+ * @return 'true' if the engine rejects the given population size.
+ */
+template <typename G> bool rejects(unsigned int pSize) {
+    try {
+        G engine(DIMENSION, pSize, 7);
+    } catch(const std::invalid_argument &) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Train an engine with the given number of threads.
+ * @param best Receives the best vector.
+ * @return 'true' if the minimum is reached and the reported score is the
+ * one of the best vector.
+ */
+template <typename G, typename E> bool train(G &engine, E &env, const char *name,
+        unsigned int threads, double *best) {
+    double lower[DIMENSION];
+    double upper[DIMENSION];
+    for(unsigned int i = 0; i < DIMENSION; ++i) {
+        lower[i] = -5.0;
+        upper[i] = 5.0;
+    }
+    omp_set_num_threads(threads);
+    double score = engine.train(&env, MAX_GENERATION, MIN_ERROR, lower, upper);
+    std::copy(engine.best(), engine.best() + DIMENSION, best);
+    std::cout << name << ", " << threads << " thread(s) : " << score << " after "
+        << engine.generation() << " generations, " << engine.evaluations() << " evaluations" << std::endl;
+    return score <= MIN_ERROR && score == env.evaluate(best);
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: real
+int main(int, char **) {
+    Ellipsoid ellipsoid;
+    Rosenbrock rosenbrock;
+    double single[DIMENSION];
+    double multiple[DIMENSION];
+    bool valid = true;
+    bool same = true;
+
+    {
+        Headless::Logic::GA::Differential engine(DIMENSION, DE_POOL_SIZE, 7);
+        valid = train(engine, ellipsoid, "Differential evolution", 1, single) && valid;
+        valid = train(engine, ellipsoid, "Differential evolution", 4, multiple) && valid;
+        same = same && std::equal(single, single + DIMENSION, multiple);
+    }
+    {
+        Headless::Logic::GA::CMAES engine(DIMENSION, CMAES_POOL_SIZE, 7);
+        valid = train(engine, rosenbrock, "CMA-ES", 1, single) && valid;
+        valid = train(engine, rosenbrock, "CMA-ES", 4, multiple) && valid;
+        same = same && std::equal(single, single + DIMENSION, multiple);
+    }
+    std::cout << "Thread count independent : " << (same ? "yes" : "no") << std::endl;
+
+    bool minimums = rejects<Headless::Logic::GA::Differential>(3)
+        && !rejects<Headless::Logic::GA::Differential>(4)
+        && rejects<Headless::Logic::GA::CMAES>(1)
+        && !rejects<Headless::Logic::GA::CMAES>(2);
+    std::cout << "Minimum sizes enforced : " << (minimums ? "yes" : "no") << std::endl;
+
+    return valid && same && minimums ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+#include <geneticalgorithmsteadystate.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#define GENOME_SIZE 48
+#define GENE_RANGE 32
+#define POOL_SIZE 128
+#define MAX_BIRTH 400000
+#define MIN_ERROR 0.5
+#define RESULT_COUNT 8
+#define MEMO_SIZE 4096
+
+using Headless::Logic::GA::Random;
+
+// Steady-state engine: evaluations of varying cost, offspring inserted as
+// soon as evaluated. Parents are copied out of the pool through the
+// environment 'copy' method. Training must reach the goal and counters must
+// be consistent.
+
+// Candidate -----------------------------------------------------------------
+struct Candidate {
+    int gene[GENOME_SIZE];
+};
+
+// Candidate Hash ------------------------------------------------------------
+class CandidateHash {
+    public:
+        std::size_t hash(const Candidate *) const;
+        bool equals(const Candidate *, const Candidate *) const;
+};
+
+std::size_t CandidateHash::hash(const Candidate *candidate) const {
+    // FNV-1a.
+    std::size_t hash = 14695981039346656037ULL;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        hash = (hash ^ static_cast<unsigned int>(candidate->gene[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool CandidateHash::equals(const Candidate *a, const Candidate *b) const {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        if(a->gene[i] != b->gene[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Environment ---------------------------------------------------------------
+// 'evaluate' is called concurrently, the other methods under the engine lock.
+class Environment {
+    public:
+        Environment();
+        void reserve(Candidate**&, unsigned int, Random &);
+        void release(Candidate**, unsigned int);
+        double evaluate(const Candidate *);
+        void copy(const Candidate *, Candidate *);
+        Candidate *clone(const Candidate *);
+        unsigned long long copies() const { return _copies; }
+        unsigned long long checksum() const { return _checksum.load(); }
+    private:
+        int _goal[GENOME_SIZE];
+        unsigned long long _copies;
+        std::atomic<unsigned long long> _checksum;
+};
+
+Environment::Environment() : _copies(0), _checksum(0) {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        _goal[i] = (i * 11) % GENE_RANGE;
+    }
+}
+
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Candidate();
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            buffer[i]->gene[j] = random.below(GENE_RANGE);
+        }
+    }
+}
+
+void Environment::release(Candidate** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+double Environment::evaluate(const Candidate *candidate) {
+    double error = 0.0;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        error += std::abs(candidate->gene[i] - _goal[i]);
+    }
+    // Extra work, from none to a lot, depending on the candidate.
+    unsigned long long work = 0;
+    for(unsigned int i = 0; i < (candidate->gene[0] & 7) * 1000u; ++i) {
+        work = work * 6364136223846793005ULL + i;
+    }
+    _checksum += work;
+    return error;
+}
+
+void Environment::copy(const Candidate *source, Candidate *target) {
+    *target = *source;
+    ++_copies;
+}
+
+Candidate *Environment::clone(const Candidate *candidate) {
+    return new Candidate(*candidate);
+}
+
+// Crossover -----------------------------------------------------------------
+class Crossover {
+    public:
+        double threshold() { return 0.5; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void Crossover::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    unsigned int cut = 1 + random.below(GENOME_SIZE - 1);
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        offspring->gene[i] = parents[i < cut ? 0 : 1]->gene[i];
+    }
+}
+
+// Point Mutator -------------------------------------------------------------
+class PointMutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void PointMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    *offspring = *parents[0];
+    unsigned int gene = random.below(GENOME_SIZE);
+    offspring->gene[gene] += random.below(2) == 1 ? 1 : -1;
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: steadystate [seed]
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 7;
+    Headless::Logic::GA::SteadyState<Candidate,
+        Headless::Logic::GA::Memo<Candidate, CandidateHash, MEMO_SIZE>,
+        Headless::Logic::GA::Tournament<3> > engine(POOL_SIZE, seed);
+    engine.refresh() = 4;
+
+    Environment env;
+    Crossover crossover;
+    PointMutator mutate;
+    Candidate **store = new Candidate*[RESULT_COUNT];
+
+    int result = engine.train(&env, MAX_BIRTH, MIN_ERROR, 0.1,
+            store, RESULT_COUNT, &crossover, &mutate);
+
+    std::cout << "Seed " << seed << std::endl;
+    std::cout << "Births " << engine.births() << std::endl;
+    std::cout << "Evaluations " << engine.evaluations() << std::endl;
+    std::cout << "Insertions " << engine.insertions() << std::endl;
+    std::cout << "Parent copies " << env.copies() << std::endl;
+
+    // Results are sorted; every birth is evaluated or found in the memo.
+    bool sorted = true;
+    for(int i = 1; i < result; ++i) {
+        sorted = sorted && env.evaluate(store[i - 1]) <= env.evaluate(store[i]);
+    }
+    bool consistent = engine.evaluations() <= engine.births() + POOL_SIZE
+        && engine.insertions() <= engine.births() && env.copies() >= engine.births();
+    double best = result > 0 ? env.evaluate(store[0]) : -1.0;
+    std::cout << "Best error " << best << std::endl;
+
+    for(unsigned int i = 0; i < static_cast<unsigned int>(result); ++i) {
+        delete store[i];
+    }
+    delete[] store;
+
+    return 0 == best && sorted && consistent ? 0 : 1;
+}
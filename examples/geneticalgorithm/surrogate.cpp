@@ -0,0 +1,194 @@
+#include <geneticalgorithm.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#define GENOME_SIZE 32
+#define GENE_RANGE 64
+#define POOL_SIZE 128
+#define MAX_GENERATION 2000
+#define MIN_ERROR 0.5
+#define MEMO_SIZE 4096
+
+using Headless::Logic::GA::Changes;
+using Headless::Logic::GA::Random;
+
+// Surrogate pre-screening together with delta evaluation: offspring with a
+// predicted score must never be evaluated out of it. Every delta is checked
+// against a full evaluation.
+
+// Candidate -----------------------------------------------------------------
+struct Candidate {
+    int gene[GENOME_SIZE];
+};
+
+// Candidate Hash ------------------------------------------------------------
+class CandidateHash {
+    public:
+        std::size_t hash(const Candidate *) const;
+        bool equals(const Candidate *, const Candidate *) const;
+};
+
+std::size_t CandidateHash::hash(const Candidate *candidate) const {
+    // FNV-1a.
+    std::size_t hash = 14695981039346656037ULL;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        hash = (hash ^ static_cast<unsigned int>(candidate->gene[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool CandidateHash::equals(const Candidate *a, const Candidate *b) const {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        if(a->gene[i] != b->gene[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Candidate Distance --------------------------------------------------------
+class CandidateDistance {
+    public:
+        double distance(const Candidate *, const Candidate *) const;
+};
+
+double CandidateDistance::distance(const Candidate *a, const Candidate *b) const {
+    double distance = 0.0;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        distance += std::abs(a->gene[i] - b->gene[i]);
+    }
+    return distance;
+}
+
+// Environment ---------------------------------------------------------------
+class Environment {
+    public:
+        Environment();
+        void reserve(Candidate**&, unsigned int, Random &);
+        void release(Candidate**, unsigned int);
+        double evaluate(const Candidate *);
+        double evaluateDelta(const Candidate *, const Candidate *, double, const Changes &);
+        Candidate *clone(const Candidate *);
+        unsigned long long deltas() const { return _deltas.load(); }
+        unsigned long long errors() const { return _errors.load(); }
+    private:
+        int _goal[GENOME_SIZE];
+        std::atomic<unsigned long long> _deltas;
+        std::atomic<unsigned long long> _errors;
+};
+
+Environment::Environment() : _deltas(0), _errors(0) {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        _goal[i] = (i * 37) % GENE_RANGE;
+    }
+}
+
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Candidate();
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            buffer[i]->gene[j] = random.below(GENE_RANGE);
+        }
+    }
+}
+
+void Environment::release(Candidate** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+double Environment::evaluate(const Candidate *candidate) {
+    double error = 0.0;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        error += std::abs(candidate->gene[i] - _goal[i]);
+    }
+    return error;
+}
+
+double Environment::evaluateDelta(const Candidate *offspring, const Candidate *parent,
+        double parentScore, const Changes &changes) {
+    double error = parentScore;
+    for(unsigned int i = 0; i < changes.size(); ++i) {
+        unsigned int gene = changes[i];
+        error += std::abs(offspring->gene[gene] - _goal[gene]);
+        error -= std::abs(parent->gene[gene] - _goal[gene]);
+    }
+    ++_deltas;
+    if(error != evaluate(offspring)) {
+        ++_errors;
+    }
+    return error;
+}
+
+Candidate *Environment::clone(const Candidate *candidate) {
+    return new Candidate(*candidate);
+}
+
+// Crossover -----------------------------------------------------------------
+class Crossover {
+    public:
+        double threshold() { return 0.5; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void Crossover::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    // Changes are not told: the offspring is fully evaluated.
+    unsigned int cut = 1 + random.below(GENOME_SIZE - 1);
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        offspring->gene[i] = parents[i < cut ? 0 : 1]->gene[i];
+    }
+}
+
+// Point Mutator -------------------------------------------------------------
+class PointMutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &, Changes &);
+};
+
+void PointMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random, Changes &changes) {
+    *offspring = *parents[0];
+    unsigned int gene = random.below(GENOME_SIZE);
+    offspring->gene[gene] = random.below(GENE_RANGE);
+    changes.add(gene);
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: surrogate [seed]
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 7;
+    Headless::Logic::GA::Trivial<Candidate,
+        Headless::Logic::GA::Memo<Candidate, CandidateHash, MEMO_SIZE>,
+        Headless::Logic::GA::Tournament<3>,
+        Headless::Logic::GA::Cascade,
+        Headless::Logic::GA::NullObserver,
+        Headless::Logic::GA::Nearest<Candidate, CandidateDistance> > engine(POOL_SIZE, seed);
+    engine.surrogate().ratio() = 0.25;
+
+    Environment env;
+    Crossover crossover;
+    PointMutator mutate;
+    Candidate **store = new Candidate*[POOL_SIZE];
+
+    int result = engine.train(&env, MAX_GENERATION, MIN_ERROR, 0.1,
+            store, POOL_SIZE, &crossover, &mutate);
+
+    double best = result > 0 ? env.evaluate(store[0]) : -1.0;
+    std::cout << "Seed " << seed << std::endl;
+    std::cout << "Generations " << engine.generation() << std::endl;
+    std::cout << "Evaluations " << engine.evaluations() << std::endl;
+    std::cout << "Deltas " << env.deltas() << " (" << env.errors() << " wrong)" << std::endl;
+    std::cout << "Best error " << best << std::endl;
+
+    for(unsigned int i = 0; i < static_cast<unsigned int>(result); ++i) {
+        delete store[i];
+    }
+    delete[] store;
+
+    return 0 == env.errors() && 0 == best ? 0 : 1;
+}
@@ -1,18 +1,30 @@
 #include <geneticalgorithm.hpp>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <random>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define POOL_SIZE 256
 #define MAX_GENERATION 1000000
 #define MIN_ERROR 0.08
+#define MEMO_SIZE 4096
+#define STAGNATION_WINDOW 1000
+#define TIME_BUDGET 10.0
 
-std::random_device s_rd;
-std::mt19937 s_mt(s_rd());
-std::uniform_int_distribution<char> s_upperDist('A', 'Z');
-std::uniform_int_distribution<char> s_lowerDist('a', 'z');
-std::uniform_int_distribution<int> s_cass(0, 1);
-std::uniform_real_distribution<double> s_range(0, 1);
+using Headless::Logic::GA::Changes;
+using Headless::Logic::GA::Random;
+
+// Draw a random letter.
+char letter(Random &random) {
+    if(random.below(2) == 1) { // upper case
+        return 'A' + random.below(26);
+    }
+    return 'a' + random.below(26);
+}
 
 
 // Candidate -----------------------------------------------------------------
@@ -21,6 +33,7 @@ class Candidate {
         Candidate();
         Candidate(const Candidate &);
         char *data() { return _data; }
+        const char *data() const { return _data; }
         double distance(const Candidate &);
         const Candidate &operator=(const Candidate &);
     private:
@@ -58,13 +71,43 @@ const Candidate& Candidate::operator=(const Candidate &other) {
     return *this;
 }
 
+// Candidate Hash ------------------------------------------------------------
+class CandidateHash {
+    public:
+        std::size_t hash(const Candidate *) const;
+        bool equals(const Candidate *, const Candidate *) const;
+};
+
+std::size_t CandidateHash::hash(const Candidate *candidate) const {
+    // FNV-1a.
+    std::size_t hash = 14695981039346656037ULL;
+    const char *data = candidate->data();
+    for(unsigned int i = 0; i < 8; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool CandidateHash::equals(const Candidate *a, const Candidate *b) const {
+    const char *left = a->data();
+    const char *right = b->data();
+    for(unsigned int i = 0; i < 8; ++i) {
+        if(left[i] != right[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Environment ---------------------------------------------------------------
 class Environment {
     public:
         void set(Candidate &goal);
-        void reserve(Candidate**&, unsigned int);
+        void reserve(Candidate**&, unsigned int, Random &);
         void release(Candidate**, unsigned int);
         double evaluate(const Candidate *);
+        void evaluate(const Candidate * const *, unsigned int, double *);
+        double evaluateDelta(const Candidate *, const Candidate *, double, const Changes &);
         Candidate *clone(const Candidate *);
     private:
         Candidate _goal;
@@ -74,17 +117,13 @@ void Environment::set(Candidate &goal) {
     _goal = goal;
 }
 
-void Environment::reserve(Candidate**& buffer, unsigned int size) {
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
     // perform an uniform distribution.
     for(unsigned int i = 0; i < size; ++i) {
         Candidate *candidate = new Candidate();
         char *data = candidate->data();
         for(unsigned int j = 0; j < 7; ++j) {
-            if(s_cass(s_mt) == 1) { // upper case
-                data[j] = s_upperDist(s_mt);
-            } else {
-                data[j] = s_lowerDist(s_mt);
-            }
+            data[j] = letter(random);
         }
         data[7] = '\0';
         buffer[i] = candidate;
@@ -101,6 +140,41 @@ double Environment::evaluate(const Candidate *candidate) {
     return _goal.distance(*candidate);
 }
 
+void Environment::evaluate(const Candidate * const *candidates, unsigned int count,
+        double *scores) {
+    unsigned int i = 0;
+#ifdef __SSE2__
+    // Two candidates per register: the sum of absolute differences of their
+    // bytes and the goal's is exactly the scalar distance times 7.
+    __m128i goal = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(_goal.data()));
+    goal = _mm_unpacklo_epi64(goal, goal);
+    for(; i + 1 < count; i += 2) {
+        __m128i first = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(candidates[i]->data()));
+        __m128i second = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(candidates[i + 1]->data()));
+        __m128i sad = _mm_sad_epu8(_mm_unpacklo_epi64(first, second), goal);
+        scores[i] = _mm_cvtsi128_si32(sad) / 7.0;
+        scores[i + 1] = _mm_extract_epi16(sad, 4) / 7.0;
+    }
+#endif
+    for(; i < count; ++i) {
+        scores[i] = evaluate(candidates[i]);
+    }
+}
+
+double Environment::evaluateDelta(const Candidate *offspring, const Candidate *parent,
+        double parentScore, const Changes &changes) {
+    // Work on the integer distance so that the score is exactly the one of a
+    // full evaluation.
+    long distance = std::lround(parentScore * 7.0);
+    const char *goal = _goal.data();
+    for(unsigned int i = 0; i < changes.size(); ++i) {
+        unsigned int gene = changes[i];
+        distance += std::abs(offspring->data()[gene] - goal[gene]);
+        distance -= std::abs(parent->data()[gene] - goal[gene]);
+    }
+    return distance / 7.0;
+}
+
 Candidate *Environment::clone(const Candidate *candidate) {
     return new Candidate(*candidate);
 }
@@ -109,45 +183,59 @@ Candidate *Environment::clone(const Candidate *candidate) {
 class MateMutator {
     public:
         double threshold();
-        void mutate(Candidate**, unsigned int, Candidate*);
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
 };
 
 double MateMutator::threshold() { return 0.8; }
 
-void MateMutator::mutate(Candidate** parents, unsigned int size, Candidate* offspring) {
-  // Nothing for now.
+void MateMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    // One-point crossover of the two selected parents.
+    unsigned int cut = 1 + random.below(6);
+    const char *first = parents[0]->data();
+    const char *second = parents[1]->data();
+    char *data = offspring->data();
+    for(unsigned int i = 0; i < 8; ++i) {
+        data[i] = i < cut ? first[i] : second[i];
+    }
 }
 
 // Classic Mutator -----------------------------------------------------------
 class ClassicMutator {
     public:
         double threshold();
-        void mutate(Candidate**, unsigned int, Candidate*);
+        unsigned int arity();
+        void mutate(Candidate**, unsigned int, Candidate*, Random &, Changes &);
 };
 
 
 double ClassicMutator::threshold() { return 0.3; }
 
-void ClassicMutator::mutate(Candidate** parents, unsigned int size, Candidate* offspring) {
-    // Let's take one of the offspring and mutate its genes !
-    unsigned int index = static_cast<unsigned int>(s_range(s_mt) * (size - 1));
-    Candidate *parent = parents[index];
-    *offspring = *parent; // Copy ...
+unsigned int ClassicMutator::arity() { return 1; }
+
+void ClassicMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random, Changes &changes) {
+    // Let's take the selected parent and mutate its genes !
+    *offspring = *parents[0]; // Copy ...
     // ... and mutate one of the character.
-    index = static_cast<unsigned int>(s_range(s_mt) * 7);
+    unsigned int index = random.below(7);
     char *data = offspring->data();
-    if(s_cass(s_mt) == 1) { // upper case
-        data[index] = s_upperDist(s_mt);
-    } else {
-        data[index] = s_lowerDist(s_mt);
-    }
+    data[index] = letter(random);
+    // Only this one has to be evaluated again.
+    changes.add(index);
 }
 
 
 
 // Example Entry Point -------------------------------------------------------
-int main(void) {
-    Headless::Logic::GA::Trivial<Candidate> engine(POOL_SIZE);
+// Usage: trivial [seed]
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::random_device()();
+    Headless::Logic::GA::Trivial<Candidate,
+        Headless::Logic::GA::Memo<Candidate, CandidateHash, MEMO_SIZE>,
+        Headless::Logic::GA::Truncation,
+        Headless::Logic::GA::Adaptive> engine(POOL_SIZE, seed);
+    std::cout << "Seed " << seed << std::endl;
 
     Environment env;
     MateMutator mate;
@@ -169,15 +257,31 @@ int main(void) {
 
     Candidate **store = new Candidate*[POOL_SIZE];
 
+    // Give up on long stagnation or after the time budget, and stream
+    // improvements as they come.
+    engine.criteria().window = STAGNATION_WINDOW;
+    engine.criteria().seconds = TIME_BUDGET;
+    double best = -1.0;
+    engine.callback([&best](const Headless::Logic::GA::Progress<Candidate> &progress) {
+        if(best < 0.0 || progress.scores[0] < best) {
+            best = progress.scores[0];
+            std::cout << "Generation " << progress.generation << " : "
+                << progress.elite[0]->data() << " (" << best << ")" << std::endl;
+        }
+        return true;
+    });
+
     int result = engine.train(&env,
             MAX_GENERATION, MIN_ERROR, 0.1,
             store, POOL_SIZE,
-            &mutate);
+            &mate, &mutate);
 
     std::cout << "Number of results " << result << std::endl;
+    std::cout << "Mate probability " << engine.scheduler().probability(0) << std::endl;
+    std::cout << "Mutate probability " << engine.scheduler().probability(1) << std::endl;
 
 
-    for(unsigned int i = 0; i < POOL_SIZE; ++i) {
+    for(unsigned int i = 0; i < static_cast<unsigned int>(result); ++i) {
         std::cout << "#" << i << " : " << store[i]->data() << std::endl;
         delete store[i];
     }
@@ -0,0 +1,152 @@
+#include <geneticalgorithmworkers.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <unistd.h>
+
+#define GENOME_SIZE 8
+#define GENE_RANGE 64
+#define POOL_SIZE 64
+#define MAX_GENERATION 500
+#define MIN_ERROR 0.5
+#define RESULT_COUNT 4
+#define WORKER_COUNT 3
+#define WORKER_TIMEOUT 100
+
+using Headless::Logic::GA::Random;
+
+// Out-of-process evaluation of a fitness function that is not thread-safe,
+// crashes on some candidates and hangs on others. Training must reach the
+// goal; crashing and hanging candidates must get the failure score.
+
+// Candidate -----------------------------------------------------------------
+struct Candidate {
+    int gene[GENOME_SIZE];
+};
+
+// Environment ---------------------------------------------------------------
+// Evaluation goes through a shared scratch buffer: it is not thread-safe.
+class Environment {
+    public:
+        Environment();
+        void reserve(Candidate**&, unsigned int, Random &);
+        void release(Candidate**, unsigned int);
+        double evaluate(const Candidate *);
+        Candidate *clone(const Candidate *);
+        static bool crashes(const Candidate *candidate) { return 13 == candidate->gene[0]; }
+        static bool hangs(const Candidate *candidate) { return 17 == candidate->gene[0]; }
+    private:
+        int _goal[GENOME_SIZE];
+        int _scratch[GENOME_SIZE];
+};
+
+Environment::Environment() {
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        _goal[i] = (i * 23) % GENE_RANGE;
+    }
+}
+
+void Environment::reserve(Candidate**& buffer, unsigned int size, Random &random) {
+    for(unsigned int i = 0; i < size; ++i) {
+        buffer[i] = new Candidate();
+        for(unsigned int j = 0; j < GENOME_SIZE; ++j) {
+            buffer[i]->gene[j] = random.below(GENE_RANGE);
+        }
+    }
+}
+
+void Environment::release(Candidate** buffer, unsigned int size) {
+    for(unsigned int i = 0; i < size; ++i) {
+        delete buffer[i];
+    }
+}
+
+double Environment::evaluate(const Candidate *candidate) {
+    if(crashes(candidate)) {
+        std::abort();
+    }
+    while(hangs(candidate)) {
+        pause();
+    }
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        _scratch[i] = std::abs(candidate->gene[i] - _goal[i]);
+    }
+    double error = 0.0;
+    for(unsigned int i = 0; i < GENOME_SIZE; ++i) {
+        error += _scratch[i];
+    }
+    return error;
+}
+
+Candidate *Environment::clone(const Candidate *candidate) {
+    return new Candidate(*candidate);
+}
+
+// Serializer ----------------------------------------------------------------
+class Serializer {
+    public:
+        void write(std::ostream &out, const Candidate *candidate) {
+            out.write(reinterpret_cast<const char *>(candidate->gene), sizeof(candidate->gene));
+        }
+        void read(std::istream &in, Candidate *candidate) {
+            in.read(reinterpret_cast<char *>(candidate->gene), sizeof(candidate->gene));
+        }
+};
+
+// Point Mutator -------------------------------------------------------------
+class PointMutator {
+    public:
+        double threshold() { return 1.0; }
+        unsigned int arity() { return 1; }
+        void mutate(Candidate**, unsigned int, Candidate*, Random &);
+};
+
+void PointMutator::mutate(Candidate** parents, unsigned int, Candidate* offspring,
+        Random &random) {
+    *offspring = *parents[0];
+    offspring->gene[random.below(GENOME_SIZE)] = random.below(GENE_RANGE);
+}
+
+// Example Entry Point -------------------------------------------------------
+// Usage: workers [seed]
+int main(int argc, char **argv) {
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 7;
+
+    // Workers are forked before any thread is started.
+    Environment env;
+    Serializer serializer;
+    Headless::Logic::GA::Workers<Environment, Candidate, Serializer> workers(&env,
+            &serializer, WORKER_COUNT);
+    workers.timeout() = WORKER_TIMEOUT;
+
+    // A crashing and a hanging candidate get the failure score.
+    Candidate probe;
+    probe.gene[0] = 13;
+    double crashed;
+    const Candidate *candidate = &probe;
+    workers.evaluate(&candidate, 1, &crashed);
+    probe.gene[0] = 17;
+    double hung;
+    workers.evaluate(&candidate, 1, &hung);
+    bool failed = std::isinf(crashed) && std::isinf(hung);
+
+    Headless::Logic::GA::Trivial<Candidate> engine(POOL_SIZE, seed);
+    PointMutator mutate;
+    Candidate **store = new Candidate*[RESULT_COUNT];
+    int result = engine.train(&workers, MAX_GENERATION, MIN_ERROR, 0.2,
+            store, RESULT_COUNT, &mutate);
+
+    double best = result > 0 ? env.evaluate(store[0]) : -1.0;
+    std::cout << "Seed " << seed << std::endl;
+    std::cout << "Failure scores : " << (failed ? "OK" : "NOK") << std::endl;
+    std::cout << "Generations " << engine.generation() << std::endl;
+    std::cout << "Restarts " << workers.restarts() << std::endl;
+    std::cout << "Best error " << best << std::endl;
+
+    for(unsigned int i = 0; i < static_cast<unsigned int>(result); ++i) {
+        delete store[i];
+    }
+    delete[] store;
+
+    return failed && 0 == best && workers.restarts() >= 2 ? 0 : 1;
+}
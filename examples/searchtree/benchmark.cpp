@@ -0,0 +1,359 @@
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "searchtree.hpp"
+#include "common.hpp"
+
+#define BENCHMARK_ZONE_SIZE 1000.0
+#define BENCHMARK_BUFFER_SIZE 65536
+#define BENCHMARK_QUERY_COUNT 20000
+#define BENCHMARK_FETCH_COUNT 100
+#define BENCHMARK_SAMPLE_SIZE 16
+#define BENCHMARK_CHURN_COUNT 100000
+#define BENCHMARK_MOVE_TICKS 10
+#define BENCHMARK_MOVE_STEP 2.0
+#define BENCHMARK_CLUSTER_COUNT 16
+#define BENCHMARK_GRID_STEP 1.0
+
+typedef Headless::Logic::SearchTree::Node<glm::vec2, Region, Element,
+        Headless::Logic::SearchTree::Statistics> Tree;
+typedef Headless::Logic::SearchTree::Statistics::Counters Counters;
+typedef std::chrono::steady_clock Clock;
+
+// Key distributions ---------------------------------------------------------
+enum Distribution { UNIFORM, CLUSTERED, GAUSSIAN, GRID, DISTRIBUTION_COUNT };
+
+const char *s_distributionNames[] = { "uniform", "clustered", "gaussian", "grid" };
+
+class Generator {
+    public:
+        Generator(Distribution distribution, unsigned int seed);
+        glm::vec2 draw();
+        glm::vec2 move(const glm::vec2 &from);
+        std::mt19937 &engine() { return _mt; }
+    private:
+        glm::vec2 clamp(double x, double y) const;
+    private:
+        Distribution _distribution;
+        std::mt19937 _mt;
+        std::uniform_real_distribution<double> _uniform;
+        std::normal_distribution<double> _normal;
+        glm::vec2 _centers[BENCHMARK_CLUSTER_COUNT];
+};
+
+Generator::Generator(Distribution distribution, unsigned int seed) :
+    _distribution(distribution), _mt(seed), _uniform(0.0, BENCHMARK_ZONE_SIZE), _normal(0.0, 1.0) {
+    for(unsigned int i = 0; i < BENCHMARK_CLUSTER_COUNT; ++i) {
+        _centers[i] = glm::vec2(_uniform(_mt), _uniform(_mt));
+    }
+}
+
+glm::vec2 Generator::clamp(double x, double y) const {
+    x = x < 0.0 ? 0.0 : (x > BENCHMARK_ZONE_SIZE ? BENCHMARK_ZONE_SIZE : x);
+    y = y < 0.0 ? 0.0 : (y > BENCHMARK_ZONE_SIZE ? BENCHMARK_ZONE_SIZE : y);
+    if(GRID == _distribution) {
+        x = static_cast<int>(x / BENCHMARK_GRID_STEP) * BENCHMARK_GRID_STEP;
+        y = static_cast<int>(y / BENCHMARK_GRID_STEP) * BENCHMARK_GRID_STEP;
+    }
+    return glm::vec2(x, y);
+}
+
+glm::vec2 Generator::draw() {
+    switch(_distribution) {
+        case CLUSTERED: {
+            const glm::vec2 &center = _centers[_mt() % BENCHMARK_CLUSTER_COUNT];
+            double sigma = BENCHMARK_ZONE_SIZE / 64.0;
+            return clamp(center.x + _normal(_mt) * sigma, center.y + _normal(_mt) * sigma);
+        }
+        case GAUSSIAN: {
+            double sigma = BENCHMARK_ZONE_SIZE / 8.0;
+            double middle = BENCHMARK_ZONE_SIZE / 2.0;
+            return clamp(middle + _normal(_mt) * sigma, middle + _normal(_mt) * sigma);
+        }
+        default:
+            return clamp(_uniform(_mt), _uniform(_mt));
+    }
+}
+
+glm::vec2 Generator::move(const glm::vec2 &from) {
+    double step = GRID == _distribution ? BENCHMARK_GRID_STEP : BENCHMARK_MOVE_STEP;
+    return clamp(from.x + _normal(_mt) * step, from.y + _normal(_mt) * step);
+}
+
+// Measures ------------------------------------------------------------------
+class Series {
+    public:
+        void clear() { _samples.clear(); }
+        void add(Clock::duration duration) {
+            _samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        }
+        void print(std::ostream &out, const Counters &before, const Counters &after);
+    private:
+        double percentile(double rank) const;
+    private:
+        std::vector<long long> _samples;
+};
+
+double Series::percentile(double rank) const {
+    if(_samples.empty()) {
+        return 0.0;
+    }
+    unsigned int index = static_cast<unsigned int>(rank * (_samples.size() - 1) + 0.5);
+    return _samples[index];
+}
+
+void Series::print(std::ostream &out, const Counters &before, const Counters &after) {
+    std::sort(_samples.begin(), _samples.end());
+    double total = 0.0;
+    for(unsigned int i = 0; i < _samples.size(); ++i) {
+        total += _samples[i];
+    }
+    double count = _samples.empty() ? 1.0 : _samples.size();
+    out << "{\"count\": " << _samples.size()
+        << ", \"mean\": " << total / count
+        << ", \"p50\": " << percentile(0.5)
+        << ", \"p99\": " << percentile(0.99)
+        << ", \"p999\": " << percentile(0.999)
+        << ", \"max\": " << (_samples.empty() ? 0 : _samples.back())
+        << ", \"allocations\": " << after.allocations - before.allocations
+        << ", \"bytes\": " << after.bytes - before.bytes
+        << ", \"entered\": " << (after.entered - before.entered) / count
+        << ", \"regions\": " << (after.regions - before.regions) / count
+        << ", \"keys\": " << (after.keys - before.keys) / count
+        << ", \"elements\": " << (after.elements - before.elements) / count
+        << "}";
+}
+
+// Benchmark -----------------------------------------------------------------
+class Benchmark {
+    public:
+        Benchmark(Distribution distribution, unsigned int cardinality,
+                unsigned int count, unsigned int seed);
+        ~Benchmark();
+        void run(std::ostream &out);
+    private:
+        template <typename F> void phase(std::ostream &out, const char *name, F operation);
+        template <typename S> void query(std::ostream &out, const char *name,
+                unsigned int count, S &shape);
+    private:
+        Distribution _distribution;
+        unsigned int _cardinality;
+        unsigned int _count;
+        Generator _generator;
+        Region _region;
+        Element **_pool;
+        Element **_result;
+        Tree *_tree;
+        Series _series;
+};
+
+Benchmark::Benchmark(Distribution distribution, unsigned int cardinality,
+        unsigned int count, unsigned int seed) :
+    _distribution(distribution), _cardinality(cardinality), _count(count),
+    _generator(distribution, seed),
+    _region(glm::vec4(0.0, 0.0, BENCHMARK_ZONE_SIZE, BENCHMARK_ZONE_SIZE)) {
+    _pool = new Element*[count];
+    for(unsigned int i = 0; i < count; ++i) {
+        _pool[i] = new Element(_generator.draw(), std::string());
+    }
+    _result = new Element*[BENCHMARK_BUFFER_SIZE];
+    _tree = new Tree(&_region, cardinality);
+}
+
+Benchmark::~Benchmark() {
+    delete _tree;
+    for(unsigned int i = 0; i < _count; ++i) {
+        delete _pool[i];
+    }
+    delete []_pool;
+    delete []_result;
+}
+
+template <typename F> void Benchmark::phase(std::ostream &out, const char *name, F operation) {
+    _series.clear();
+    Counters before = _tree->statistics().counters();
+    operation();
+    out << ",\n      \"" << name << "\": ";
+    _series.print(out, before, _tree->statistics().counters());
+}
+
+template <typename S> void Benchmark::query(std::ostream &out, const char *name,
+        unsigned int count, S &shape) {
+    phase(out, name, [&]() {
+        for(unsigned int i = 0; i < count; ++i) {
+            shape.set(_generator.draw());
+            Clock::time_point start = Clock::now();
+            (void) _tree->retrieve(shape, _result, BENCHMARK_BUFFER_SIZE);
+            _series.add(Clock::now() - start);
+        }
+    });
+}
+
+/**
+ * Square search shape centered on a key.
+ */
+class Square : public Region {
+    public:
+        Square(double size) : _size(size) {}
+        void set(const glm::vec2 &center) {
+            *this = glm::vec4(center.x - _size / 2.0, center.y - _size / 2.0, _size, _size);
+        }
+        using Region::operator=;
+    private:
+        double _size;
+};
+
+/**
+ * Disc search shape of fixed radius.
+ */
+class Circle : public Disc {
+    public:
+        Circle(double radius) : _radius(radius) {}
+        void set(const glm::vec2 &center) { Disc::set(center, _radius); }
+    private:
+        double _radius;
+};
+
+/**
+ * Whole zone search shape.
+ */
+class Everything : public Region {
+    public:
+        Everything() : Region(glm::vec4(0.0, 0.0, BENCHMARK_ZONE_SIZE, BENCHMARK_ZONE_SIZE)) {}
+        void set(const glm::vec2 &) {}
+};
+
+void Benchmark::run(std::ostream &out) {
+    out << "    {\"distribution\": \"" << s_distributionNames[_distribution]
+        << "\", \"cardinality\": " << _cardinality
+        << ", \"elements\": " << _count;
+
+    phase(out, "add", [&]() {
+        for(unsigned int i = 0; i < _count; ++i) {
+            Clock::time_point start = Clock::now();
+            _tree->add(_pool[i]);
+            _series.add(Clock::now() - start);
+        }
+    });
+
+    Headless::Logic::SearchTree::Structure structure;
+    _tree->report(structure);
+    out << ",\n      \"depth\": " << structure.depth
+        << ", \"leaves\": " << structure.leafCount
+        << ", \"emptyLeaves\": " << structure.emptyLeaves
+        << ", \"fill\": " << structure.fill
+        << ", \"bytes\": " << structure.bytes;
+
+    phase(out, "removeAll", [&]() {
+        for(unsigned int i = 0; i < _count; ++i) {
+            Clock::time_point start = Clock::now();
+            _tree->remove(_pool[i]);
+            _series.add(Clock::now() - start);
+        }
+    });
+
+    delete _tree;
+    _tree = new Tree(&_region, _cardinality);
+    phase(out, "build", [&]() {
+        Element **elements = new Element*[_count];
+        std::copy(_pool, _pool + _count, elements);
+        Clock::time_point start = Clock::now();
+        _tree->build(elements, _count);
+        _series.add(Clock::now() - start);
+        delete []elements;
+    });
+
+    phase(out, "churn", [&]() {
+        std::uniform_int_distribution<unsigned int> chooser(0, _count - 1);
+        for(unsigned int i = 0; i < BENCHMARK_CHURN_COUNT; ++i) {
+            Element *element = _pool[chooser(_generator.engine())];
+            glm::vec2 key = _generator.draw();
+            Clock::time_point start = Clock::now();
+            _tree->remove(element);
+            element->set(key);
+            _tree->add(element);
+            _series.add(Clock::now() - start);
+        }
+    });
+
+    phase(out, "move", [&]() {
+        for(unsigned int t = 0; t < BENCHMARK_MOVE_TICKS; ++t) {
+            for(unsigned int i = 0; i < _count; ++i) {
+                Element *element = _pool[i];
+                glm::vec2 key = _generator.move(element->key());
+                Clock::time_point start = Clock::now();
+                _tree->remove(element);
+                element->set(key);
+                _tree->add(element);
+                _series.add(Clock::now() - start);
+            }
+        }
+    });
+
+    double sizes[] = { 8.0, 32.0, 128.0 };
+    std::string names[] = { "8", "32", "128" };
+    for(unsigned int i = 0; i < 3; ++i) {
+        Square square(sizes[i]);
+        query(out, ("region" + names[i]).c_str(), BENCHMARK_QUERY_COUNT, square);
+    }
+    for(unsigned int i = 0; i < 3; ++i) {
+        Circle circle(sizes[i] / 2.0);
+        query(out, ("disc" + names[i]).c_str(), BENCHMARK_QUERY_COUNT, circle);
+    }
+    Everything everything;
+    query(out, "fetch", BENCHMARK_FETCH_COUNT, everything);
+
+    std::vector<Tree::Candidate> candidates;
+    for(unsigned int i = 0; i < 3; ++i) {
+        Square square(sizes[i]);
+        phase(out, ("sample" + names[i]).c_str(), [&]() {
+            for(unsigned int j = 0; j < BENCHMARK_QUERY_COUNT; ++j) {
+                square.set(_generator.draw());
+                Clock::time_point start = Clock::now();
+                (void) _tree->sample(square, _result, BENCHMARK_SAMPLE_SIZE, _generator.engine(),
+                        candidates);
+                _series.add(Clock::now() - start);
+            }
+        });
+    }
+
+    out << "}";
+}
+
+/**
+ * Usage: benchmark [seed]
+ * Sample phases draw BENCHMARK_SAMPLE_SIZE elements per operation.
+ * Timings are in nanoseconds per operation. Query counters (entered,
+ * regions, keys and elements) are averaged per operation.
+ */
+int main(int argc, char **argv) {
+    unsigned int seed = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::random_device()();
+
+    unsigned int testCount[] = { 1024, 16384, 131072 };
+    unsigned int testCardinality[] = { 8, 16, 32 };
+
+    std::cout << "{\n  \"seed\": " << seed << ",\n  \"runs\": [\n";
+    bool first = true;
+    for(unsigned int d = 0; d < DISTRIBUTION_COUNT; ++d) {
+        for(unsigned int l = 0; l < 3; ++l) {
+            for(unsigned int k = 0; k < 3; ++k) {
+                std::cerr << s_distributionNames[d] << " / " << testCardinality[l]
+                    << " / " << testCount[k] << std::endl;
+                if(!first) {
+                    std::cout << ",\n";
+                }
+                first = false;
+                Benchmark benchmark(static_cast<Distribution>(d), testCardinality[l],
+                        testCount[k], seed);
+                benchmark.run(std::cout);
+            }
+        }
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
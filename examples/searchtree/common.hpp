@@ -3,14 +3,12 @@
 
 #include <glm/glm.hpp>
 #include <iostream>
-#include <set>
 #include "searchtree.hpp"
 
 class Region {
     public:
         Region() : _boundary(0.0, 0.0, 0.0, 0.0) {}
         Region(const glm::vec4 boundary) : _boundary(boundary) {}
-        Region(const Region &r) { _boundary = r._boundary; }
 
         inline Region &operator=(glm::vec4 bound) {
             _boundary = bound; return *this; }
@@ -54,26 +52,6 @@ class Element {
         std::string _name;
 };
 
-class DepthVisitor {
-    private:
-        unsigned int _depth;
-        unsigned int _maxDepth;
-    public:
-        DepthVisitor() : _depth(0), _maxDepth(0) {}
-        void init() { _depth = 0; _maxDepth = 0; }
-        unsigned int depth() { return _maxDepth; }
-        void enter(const Region &) {
-            ++_depth;
-            if(_depth > _maxDepth) {
-                _maxDepth = _depth;
-            }
-        }
-        void exit(const Region &) {
-            --_depth;
-        }
-        void inspect(Element **, unsigned int) {}
-};
-
 class Visitor {
     public:
         Visitor() : _depth(0) {}
@@ -133,71 +111,4 @@ class Visitor {
         Region currentRegion;
 };
 
-class ConsistencyVisitor {
-    public:
-        ConsistencyVisitor(unsigned int card) : _cardinality(card), _depth(0) {
-            for(unsigned int i = 0; i < 128; ++i) {
-                _count[i] = 0;
-            }
-        }
-
-        void inspect(Element **, unsigned int count) {
-            _count[_depth] = count;
-            _leaf = true;
-        }
-
-        void enter(const Region &) {
-            ++_depth;
-            _count[_depth] = 0;
-        }
-
-        void exit(const Region &) {
-            --_depth;
-            _count[_depth] += _count[_depth + 1];
-            std::cout << _depth << " : " << _count[_depth + 1];
-            if(!_leaf) {
-                if(_count[_depth+1] < _cardinality) {
-                    std::cout << " }}";
-                }
-            } else {
-                std::cout << " >";
-            }
-            std::cout << std::endl;
-            _leaf = false;
-        }
-    private:
-        bool _leaf;
-        unsigned int _cardinality;
-        unsigned int _count[128];
-        unsigned int _depth;
-};
-
-class MemoryInspector {
-    public:
-        void init() {
-            std::cout << "digraph G {" << std::endl;
-            std::cout << "node [width=0.3 height=0.3 label=\"\"]"
-                << std::endl;
-        }
-
-        void visit(Node<glm::vec2, Region, Element>* target,
-                const Region* region, Element** elements,
-                Node<glm::vec2, Region, Element>** nodes,
-                Node<glm::vec2, Region, Element>* parent,
-                bool leaf,
-                unsigned int count,
-                unsigned int cardinality) {
-            // Tree topology.
-            if(parent != nullptr) {
-                std::cout << "    \"" << parent << "\" -> \"";
-                std::cout << target << "\";" << std::endl;
-            }
-        }
-
-        void close() {
-            std::cout << "}" << std::endl;
-        }
-};
-
-
 #endif
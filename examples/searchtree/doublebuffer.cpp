@@ -0,0 +1,133 @@
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <random>
+#include <thread>
+#include "searchtree.hpp"
+#include "searchtreebuffer.hpp"
+#include "common.hpp"
+
+#define BUFFER_NODE_CARDINALITY 16
+#define ELEMENT_POOL_SIZE 20000
+#define TICK_COUNT 16
+#define TEST_SEARCH_OCCURENCE 200
+#define ZONE_SIZE 1000.0
+
+typedef Headless::Logic::SearchTree::DoubleBuffer<glm::vec2, Region, Element> Buffer;
+typedef Buffer::Tree Tree;
+
+/**
+ * Elements indexed at a given tick: all but one quarter of the pool, so
+ * that successive trees differ.
+ */
+unsigned int select(Element **pool, Element **selection, unsigned int tick) {
+    unsigned int count = 0;
+    for(unsigned int i = 0; i < ELEMENT_POOL_SIZE; ++i) {
+        if(i % 4 != tick % 4) {
+            selection[count++] = pool[i];
+        }
+    }
+    return count;
+}
+
+/**
+ * Compare a query on a tree with a brute force one.
+ * @return 'true' if both results match.
+ */
+bool check(const Tree &tree, const Region &shape, Element **selection, unsigned int count,
+        Element **expected, Element **result) {
+    unsigned int size = 0;
+    for(unsigned int i = 0; i < count; ++i) {
+        if(shape.contains(selection[i]->key())) {
+            expected[size++] = selection[i];
+        }
+    }
+    unsigned int found = tree.retrieve(shape, result, count);
+    std::sort(expected, expected + size);
+    std::sort(result, result + found);
+    return size == found && std::equal(expected, expected + size, result);
+}
+
+/**
+ * Main test procedure.
+ * A reader thread keeps querying the published tree while trees are
+ * rebuilt in background and swapped, once per tick.
+ */
+int main(int, char **) {
+    Region region(glm::vec4(0.0, 0.0, ZONE_SIZE, ZONE_SIZE));
+
+    // - Initialize the pool. Keys never change: ticks differ by the
+    // selected elements.
+    Element **pool = new Element*[ELEMENT_POOL_SIZE];
+    std::mt19937 mt(42);
+    std::uniform_real_distribution<double> dist(0.0, ZONE_SIZE);
+    for(unsigned int i = 0; i < ELEMENT_POOL_SIZE; ++i) {
+        pool[i] = new Element(glm::vec2(dist(mt), dist(mt)),
+                std::string("Element#").append(std::to_string(i)));
+    }
+    Element **selection = new Element*[ELEMENT_POOL_SIZE];
+    Element **expected = new Element*[ELEMENT_POOL_SIZE];
+    Element **result = new Element*[ELEMENT_POOL_SIZE];
+
+    Buffer buffer(&region, BUFFER_NODE_CARDINALITY);
+
+    // - Reader: a whole-region query must return a whole tree, i.e. nothing
+    // (initial one) or a selection.
+    std::atomic<bool> stop(false);
+    std::atomic<unsigned int> reads(0);
+    std::atomic<unsigned int> wrongReads(0);
+    std::thread reader([&]() {
+        Element **all = new Element*[ELEMENT_POOL_SIZE];
+        while(!stop.load()) {
+            std::shared_ptr<const Tree> tree = buffer.current();
+            unsigned int found = tree->retrieve(region, all, ELEMENT_POOL_SIZE);
+            if(0 != found && found != ELEMENT_POOL_SIZE - ELEMENT_POOL_SIZE / 4) {
+                ++wrongReads;
+            }
+            ++reads;
+        }
+        delete []all;
+    });
+
+    // - Ticks.
+    unsigned int mismatches = 0;
+    unsigned int swaps = 0;
+    for(unsigned int tick = 0; tick < TICK_COUNT; ++tick) {
+        unsigned int count = select(pool, selection, tick);
+        std::shared_ptr<const Tree> previous = buffer.current();
+        buffer.rebuild(selection, count);
+        swaps += buffer.swap() ? 1 : 0;
+        std::shared_ptr<const Tree> tree = buffer.current();
+        mismatches += tree->retrieve(region, result, ELEMENT_POOL_SIZE) == count ? 0 : 1;
+        for(unsigned int i = 0; i < TEST_SEARCH_OCCURENCE; ++i) {
+            double size = 8.0 + dist(mt) / 8.0;
+            Region shape(glm::vec4(dist(mt), dist(mt), size, size));
+            mismatches += check(*tree, shape, selection, count, expected, result) ? 0 : 1;
+        }
+        // The previous tree is still valid while held.
+        if(tick > 0) {
+            unsigned int found = previous->retrieve(region, result, ELEMENT_POOL_SIZE);
+            mismatches += found == select(pool, selection, tick - 1) ? 0 : 1;
+        }
+    }
+    stop.store(true);
+    reader.join();
+
+    std::cout << "Swaps : " << swaps << "/" << TICK_COUNT << std::endl;
+    std::cout << "Mismatches : " << mismatches << std::endl;
+    std::cout << "Reads : " << reads.load() << " (" << wrongReads.load() << " wrong)" << std::endl;
+
+    // Clean-up.
+    delete []result;
+    delete []expected;
+    delete []selection;
+    for(unsigned int i = 0; i < ELEMENT_POOL_SIZE; ++i) {
+        delete pool[i];
+    }
+    delete []pool;
+
+    // Exit.
+    return TICK_COUNT == swaps && 0 == mismatches && 0 == wrongReads.load() ? 0 : 1;
+}
@@ -1,4 +1,5 @@
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <random>
@@ -34,13 +35,14 @@ int main(void) {
     }
 
     unsigned int testPoolSize[] = { 128 };
+    unsigned int misplaced = 0;
     unsigned int testCardinality[] = { 3 };
 
     for(unsigned int l = 0; l < 1; ++l) {
 
         unsigned int cardinality = testCardinality[l];
-        Headless::Logic::SearchTree::Node<glm::vec2, Region, Element> tree(&region,
-            cardinality);
+        Headless::Logic::SearchTree::Node<glm::vec2, Region, Element,
+            Headless::Logic::SearchTree::Statistics> tree(&region, cardinality);
 
 
         for(unsigned int k = 0; k < 1; ++k) {
@@ -61,6 +63,23 @@ int main(void) {
                 tree.add(element);
             }
     
+            std::cout << ">>>>> Move" << std::endl;
+            // - Move, then look every element up at its key.
+            for(unsigned int i = 0; i < TEST_CHANGEKEY_OCCURENCE; ++i) {
+                Element *element = pool[(unsigned int) (elemChooser(mt))];
+                glm::vec2 key(dist(mt), dist(mt));
+                tree.move(element, key);
+            }
+            Element **found = new Element*[ELEMENT_BUFFER_SIZE];
+            for(unsigned int i = 0; i < poolSize; ++i) {
+                glm::vec2 key = pool[i]->key();
+                Region point(glm::vec4(key.x, key.y, 0.0, 0.0));
+                unsigned int count = tree.retrieve(point, found, ELEMENT_BUFFER_SIZE);
+                misplaced += std::find(found, found + count, pool[i]) == found + count ? 1 : 0;
+            }
+            delete []found;
+            std::cout << "Misplaced : " << misplaced << std::endl;
+
             std::cout << ">>>>> Flush/Add" << std::endl;
             // Test on flush/removal.
             for(unsigned int i = 0; i < TEST_FLUSHFILL_OCCURENCE; ++i) {
@@ -73,9 +92,19 @@ int main(void) {
                 }
             }
    
-            std::cout << ">>>>> Chech Consistency" << std::endl;
-            ConsistencyVisitor cVisitor(cardinality);
-            tree.visit(cVisitor);
+            std::cout << ">>>>> Check Structure" << std::endl;
+            Headless::Logic::SearchTree::Structure structure;
+            tree.report(structure);
+            std::cout << "Depth : " << structure.depth << std::endl;
+            for(unsigned int d = 0; d < structure.depth && d < STATISTICS_MAX_DEPTH; ++d) {
+                std::cout << "  Leaves at " << d << " : " << structure.leaves[d] << std::endl;
+            }
+            std::cout << "Nodes : " << structure.nodes << std::endl;
+            std::cout << "Leaves : " << structure.leafCount
+                << " (" << structure.emptyLeaves << " empty)" << std::endl;
+            std::cout << "Elements : " << structure.elements << std::endl;
+            std::cout << "Fill : " << structure.fill << std::endl;
+            std::cout << "Bytes : " << structure.bytes << std::endl;
             // Test on elements search.
             Region shape;
     
@@ -128,13 +157,17 @@ int main(void) {
                 tree.remove(pool[i]);
             }
         }
-#ifdef TREE_DEBUG
-        std::cout << "!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!" << std::endl;
-        MemoryInspector inspector;
-        inspector.init();
-        tree.deepVisit(inspector);
-        inspector.close();
-#endif
+        const Headless::Logic::SearchTree::Statistics::Counters& counters =
+            tree.statistics().counters();
+        std::cout << ">>>>> Statistics" << std::endl;
+        std::cout << "Entered : " << counters.entered << std::endl;
+        std::cout << "Regions : " << counters.regions << std::endl;
+        std::cout << "Keys : " << counters.keys << std::endl;
+        std::cout << "Elements : " << counters.elements << std::endl;
+        std::cout << "Splits : " << counters.splits << std::endl;
+        std::cout << "Collapses : " << counters.collapses << std::endl;
+        std::cout << "Allocations : " << counters.allocations
+            << " (" << counters.bytes << " bytes)" << std::endl;
     }
     // Clean-up.
     for(unsigned int i = 0; i < ELEMENT_POOL_SIZE; ++i) {
@@ -143,5 +176,5 @@ int main(void) {
     delete []pool;
 
     // Exit.
-    return 0;
+    return 0 == misplaced ? 0 : 1;
 }
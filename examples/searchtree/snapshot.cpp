@@ -0,0 +1,142 @@
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "searchtree.hpp"
+#include "searchtreesnapshot.hpp"
+#include "common.hpp"
+
+#define SNAPSHOT_NODE_CARDINALITY 16
+#define ELEMENT_BUFFER_SIZE 4096
+#define ELEMENT_POOL_SIZE 16384
+#define TEST_SEARCH_OCCURENCE 1000
+#define ZONE_SIZE 1000.0
+
+typedef Headless::Logic::SearchTree::Node<glm::vec2, Region, Element> Tree;
+typedef Headless::Logic::SearchTree::Snapshot<glm::vec2, Region, Element> Snapshot;
+
+/**
+ * Elements are identified by their index in the pool.
+ */
+class Mapping {
+    public:
+        Mapping(Element **pool, unsigned int size) : _pool(pool), _size(size) {
+            for(unsigned int i = 0; i < size; ++i) {
+                _ids[pool[i]] = i;
+            }
+        }
+        std::uint64_t id(const Element *element) { return _ids[element]; }
+        Element *element(std::uint64_t id) { return id < _size ? _pool[id] : nullptr; }
+    private:
+        Element **_pool;
+        unsigned int _size;
+        std::unordered_map<const Element *, std::uint64_t> _ids;
+};
+
+/**
+ * Write a damaged copy of a file.
+ * @param length Number of bytes kept.
+ * @param offset First overwritten byte.
+ * @param count Number of overwritten bytes.
+ */
+void damage(const std::string &source, const std::string &target,
+        std::size_t length, std::size_t offset, std::size_t count) {
+    std::ifstream in(source.c_str(), std::ios::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    content.resize(std::min(length, content.size()));
+    for(std::size_t i = offset; i < offset + count && i < content.size(); ++i) {
+        content[i] = '\xFF';
+    }
+    std::ofstream out(target.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(content.data(), content.size());
+}
+
+/**
+ * Main test procedure.
+ * Usage: snapshot [file]
+ */
+int main(int argc, char **argv) {
+    std::string path = argc > 1 ? argv[1] : "searchtree.snapshot";
+    std::string damaged = path + ".damaged";
+    Region region(glm::vec4(0.0, 0.0, ZONE_SIZE, ZONE_SIZE));
+
+    // - Initialize the pool.
+    Element **pool = new Element*[ELEMENT_POOL_SIZE];
+    std::mt19937 mt(42);
+    std::uniform_real_distribution<double> dist(0.0, ZONE_SIZE);
+    for(unsigned int i = 0; i < ELEMENT_POOL_SIZE; ++i) {
+        pool[i] = new Element(glm::vec2(dist(mt), dist(mt)),
+                std::string("Element#").append(std::to_string(i)));
+    }
+    Mapping mapping(pool, ELEMENT_POOL_SIZE);
+
+    // - Write and map a snapshot.
+    Tree tree(&region, SNAPSHOT_NODE_CARDINALITY);
+    for(unsigned int i = 0; i < ELEMENT_POOL_SIZE; ++i) {
+        tree.add(pool[i]);
+    }
+    Snapshot snapshot;
+    bool failed = !Snapshot::write(path.c_str(), tree, mapping) || !snapshot.open(path.c_str(), mapping);
+    std::cout << "Snapshot : " << (failed ? "NOK" : "OK") << " (" << snapshot.size() << " elements)" << std::endl;
+
+    // - Queries must match the tree ones.
+    Element **expected = new Element*[ELEMENT_BUFFER_SIZE];
+    Element **result = new Element*[ELEMENT_BUFFER_SIZE];
+    unsigned int mismatches = 0;
+    for(unsigned int i = 0; i < TEST_SEARCH_OCCURENCE; ++i) {
+        double size = 8.0 + dist(mt) / 8.0;
+        Region shape(glm::vec4(dist(mt), dist(mt), size, size));
+        unsigned int count = tree.retrieve(shape, expected, ELEMENT_BUFFER_SIZE);
+        unsigned int found = snapshot.retrieve(shape, result, ELEMENT_BUFFER_SIZE);
+        std::sort(expected, expected + count);
+        std::sort(result, result + found);
+        if(count != found || !std::equal(expected, expected + count, result)) {
+            ++mismatches;
+        }
+    }
+    std::cout << "Queries : " << TEST_SEARCH_OCCURENCE << " (" << mismatches << " mismatches)" << std::endl;
+    failed |= mismatches > 0;
+
+    // - Truncated or corrupt files must be rejected.
+    std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+    std::size_t length = static_cast<std::size_t>(in.tellg());
+    unsigned int accepted = 0;
+    for(unsigned int i = 0; i < 8; ++i) {
+        damage(path, damaged, length * i / 8, 0, 0);
+        Snapshot broken;
+        accepted += broken.open(damaged.c_str(), mapping) ? 1 : 0;
+    }
+    // Header offsets, then the root record.
+    damage(path, damaged, length, 32, 8);
+    {
+        Snapshot broken;
+        accepted += broken.open(damaged.c_str(), mapping) ? 1 : 0;
+    }
+    damage(path, damaged, length, 64, 64);
+    {
+        Snapshot broken;
+        accepted += broken.open(damaged.c_str(), mapping) ? 1 : 0;
+    }
+    std::cout << "Damaged files accepted : " << accepted << std::endl;
+    failed |= accepted > 0;
+    std::remove(damaged.c_str());
+
+    // Clean-up.
+    snapshot.close();
+    std::remove(path.c_str());
+    delete []expected;
+    delete []result;
+    for(unsigned int i = 0; i < ELEMENT_POOL_SIZE; ++i) {
+        delete pool[i];
+    }
+    delete []pool;
+
+    // Exit.
+    return failed ? 1 : 0;
+}
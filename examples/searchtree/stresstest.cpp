@@ -57,9 +57,9 @@ int main(void) {
             std::cout << std::chrono::duration_cast<std::chrono::nanoseconds>(diff).count()
                 << ", ";
     
-            DepthVisitor dVisitor;
-            tree.visit(dVisitor);
-            std::cout << dVisitor.depth() << ", ";
+            Headless::Logic::SearchTree::Structure structure;
+            tree.report(structure);
+            std::cout << structure.depth << ", ";
     
             // - Remove/Change Key/Add
             std::uniform_real_distribution<double> elemChooser(0, poolSize);
@@ -104,24 +104,18 @@ int main(void) {
                 }
                 end = std::chrono::steady_clock::now();
                 diff = end - start;
-                std::cout << std::chrono::duration_cast<std::chrono::nanoseconds>(diff).count() / TEST_CHANGEKEY_OCCURENCE << ", ";
+                std::cout << std::chrono::duration_cast<std::chrono::nanoseconds>(diff).count() / TEST_SEARCH_OCCURENCE << ", ";
             }
     
             start = std::chrono::steady_clock::now();
             for(unsigned int i = 0; i < poolSize; ++i) {
                 tree.remove(pool[i]);
             }
+            end = std::chrono::steady_clock::now();
+            diff = end - start;
             std::cout << std::chrono::duration_cast<std::chrono::nanoseconds>(diff).count()
                 << std::endl;
             delete []result;
-
-#ifdef TREE_DEBUG
-            MemoryInspector memoryInspector;
-            std::cout << "digraph G {" << std::endl;
-            memoryInspector.init();
-            tree.deepVisit(memoryInspector);
-            std::cout << "}" << std::endl;
-#endif
         }
     }
     // Clean-up.
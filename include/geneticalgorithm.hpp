@@ -16,207 +16,3056 @@
 #ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM
 #define HEADLESS_LOGIC_GENETIC_ALGORITHM
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <ostream>
 #include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define GA_MAX_ARITY 8
+#define GA_MAX_CHANGES 16
+#define GA_CHECKPOINT_VERSION 2
+
+namespace Headless {
+    namespace Logic {
+        /**
+         * Here are proposed some implementations of General Algorithms.
+         * Currently available GAs are:
+         *  - Trivial.
+         *  - Pareto, multi-objective.
+         *  - Islands (geneticalgorithmislands.hpp).
+         *  - SteadyState (geneticalgorithmsteadystate.hpp).
+         *  - Contiguous (geneticalgorithmcontiguous.hpp).
+         *  - Workers, out-of-process evaluation (geneticalgorithmworkers.hpp).
+         *  - Bits, bit-packed genomes and operators (geneticalgorithmbits.hpp).
+         *  - Novelty, novelty search and fitness sharing (geneticalgorithmnovelty.hpp).
+         *  - Differential and CMAES, real vectors (geneticalgorithmreal.hpp).
+         */
+        namespace GA {
+
+            /**
+             * Counter-based random generator (Philox 4x32-10).
+             *
+             * A stream is fully defined by a seed and a position (generation,
+             * candidate index, channel), so that a candidate gets the same
+             * random numbers whatever the thread that handles it. Creating a
+             * stream is free: there's no state to initialize.
+             *
+             * It satisfies the standard uniform random bit generator
+             * requirements and can thus feed the <random> distributions.
+             */
+            class Random {
+                public:
+                    typedef std::uint32_t result_type;
+                    /**
+                     * Stream channels, to draw unrelated numbers at the same position.
+                     */
+                    enum Channel {
+                        MUTATION = 0,
+                        INITIALIZATION = 1,
+                        EVALUATION = 2,
+                        MIGRATION = 3
+                    };
+                public:
+                    /**
+                     * Constructor.
+                     * @param seed Generator seed.
+                     * @param generation Generation number.
+                     * @param index Candidate index.
+                     * @param channel Channel.
+                     */
+                    Random(std::uint64_t seed, std::uint32_t generation,
+                            std::uint32_t index, std::uint32_t channel = MUTATION) : _index(4) {
+                        _key[0] = static_cast<std::uint32_t>(seed);
+                        _key[1] = static_cast<std::uint32_t>(seed >> 32);
+                        _counter[0] = 0;
+                        _counter[1] = channel;
+                        _counter[2] = index;
+                        _counter[3] = generation;
+                    }
+
+                    /**
+                     * @return A seed from 'std::random_device', for engines
+                     * built without one.
+                     */
+                    static std::uint64_t entropy() {
+                        std::random_device device;
+                        return (static_cast<std::uint64_t>(device()) << 32) | device();
+                    }
+
+                    static constexpr result_type min() { return 0; }
+                    static constexpr result_type max() { return 0xFFFFFFFF; }
+
+                    /**
+                     * @return Next 32 random bits.
+                     */
+                    result_type operator()() {
+                        if(4 == _index) {
+                            generate();
+                            _index = 0;
+                        }
+                        return _output[_index++];
+                    }
+
+                    /**
+                     * @return Uniform double in [0, 1).
+                     */
+                    double uniform() {
+                        std::uint64_t hi = (*this)() >> 5;
+                        std::uint64_t lo = (*this)() >> 6;
+                        return (hi * 67108864.0 + lo) * (1.0 / 9007199254740992.0);
+                    }
+
+                    /**
+                     * @param bound Exclusive upper bound. Must not be 0.
+                     * @return Uniform integer in [0, bound).
+                     */
+                    std::uint32_t below(std::uint32_t bound) {
+                        return static_cast<std::uint32_t>((static_cast<std::uint64_t>((*this)()) * bound) >> 32);
+                    }
+
+                private:
+                    /**
+                     * Compute the next block of four numbers.
+                     */
+                    void generate() {
+                        std::uint32_t c0 = _counter[0];
+                        std::uint32_t c1 = _counter[1];
+                        std::uint32_t c2 = _counter[2];
+                        std::uint32_t c3 = _counter[3];
+                        std::uint32_t k0 = _key[0];
+                        std::uint32_t k1 = _key[1];
+                        for(unsigned int i = 0; i < 10; ++i) {
+                            std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53) * c0;
+                            std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57) * c2;
+                            c0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                            c1 = static_cast<std::uint32_t>(p1);
+                            c2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                            c3 = static_cast<std::uint32_t>(p0);
+                            k0 += 0x9E3779B9;
+                            k1 += 0xBB67AE85;
+                        }
+                        _output[0] = c0;
+                        _output[1] = c1;
+                        _output[2] = c2;
+                        _output[3] = c3;
+                        ++_counter[0];
+                    }
+
+                private:
+                    /** Key, from the seed. */
+                    std::uint32_t _key[2];
+                    /** Counter: block, channel, index, generation. */
+                    std::uint32_t _counter[4];
+                    /** Current block. */
+                    std::uint32_t _output[4];
+                    /** Next number in the current block. */
+                    unsigned int  _index;
+            };
+
+            /**
+             * Genes an offspring doesn't share with its first parent, as
+             * reported by mutators for delta evaluation. Past GA_MAX_CHANGES
+             * genes, changes are unknown.
+             */
+            class Changes {
+                public:
+                    Changes() : _count(0) {}
+
+                    /**
+                     * Record a changed gene.
+                     * @param gene Gene index, as understood by the environment.
+                     */
+                    void add(unsigned int gene) {
+                        if(_count < GA_MAX_CHANGES) {
+                            _gene[_count] = gene;
+                        }
+                        _count += _count <= GA_MAX_CHANGES ? 1 : 0;
+                    }
+
+                    /**
+                     * Forget changes: the offspring must be fully evaluated.
+                     */
+                    void forget() { _count = GA_MAX_CHANGES + 1; }
+
+                    /**
+                     * Start over.
+                     */
+                    void clear() { _count = 0; }
+
+                    /**
+                     * @return 'true' if changes are all recorded.
+                     */
+                    bool known() const { return _count <= GA_MAX_CHANGES; }
+
+                    /**
+                     * @return Number of changed genes, if known.
+                     */
+                    unsigned int size() const { return _count; }
+
+                    /**
+                     * @param index Change index.
+                     * @return Changed gene.
+                     */
+                    unsigned int operator[](unsigned int index) const { return _gene[index]; }
+
+                    /**
+                     * Index, in the pool, of the first parent.
+                     */
+                    unsigned int parent;
+
+                private:
+                    unsigned int _count;
+                    unsigned int _gene[GA_MAX_CHANGES];
+            };
+
+            /**
+             * OpenMP queries, with sequential fallbacks.
+             */
+            namespace Parallel {
+                /**
+                 * @return Number of threads of the next parallel region.
+                 */
+                inline unsigned int count() {
+#ifdef _OPENMP
+                    return omp_get_max_threads();
+#else
+                    return 1;
+#endif
+                }
+
+                /**
+                 * @return Index of the calling thread in its team.
+                 */
+                inline unsigned int index() {
+#ifdef _OPENMP
+                    return omp_get_thread_num();
+#else
+                    return 0;
+#endif
+                }
+
+                /**
+                 * @return Monotonic time, in nanoseconds.
+                 */
+                inline std::uint64_t now() {
+                    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch()).count();
+                }
+            } // Namespace 'Parallel'
+
+            /**
+             * Adapters for the optional parts of the concepts. Each call
+             * uses the richest signature the concept implements.
+             */
+            namespace Concept {
+                template <typename M, typename C>
+                    auto mutate(M mutator, C** parents, unsigned int count, C* offspring,
+                            Random& random, int) -> decltype(mutator->mutate(parents, count, offspring, random), void()) {
+                        mutator->mutate(parents, count, offspring, random);
+                    }
+
+                template <typename M, typename C>
+                    void mutate(M mutator, C** parents, unsigned int count, C* offspring,
+                            Random&, long) {
+                        mutator->mutate(parents, count, offspring);
+                    }
+
+                template <typename M, typename C>
+                    auto mutate(M mutator, C** parents, unsigned int count, C* offspring,
+                            Random& random, Changes& changes, int)
+                    -> decltype(mutator->mutate(parents, count, offspring, random, changes), void()) {
+                        mutator->mutate(parents, count, offspring, random, changes);
+                    }
+
+                template <typename M, typename C>
+                    void mutate(M mutator, C** parents, unsigned int count, C* offspring,
+                            Random& random, Changes& changes, long) {
+                        mutate(mutator, parents, count, offspring, random, 0);
+                        changes.forget();
+                    }
+
+                template <typename M>
+                    auto arity(M mutator, int) -> decltype(mutator->arity()) {
+                        return mutator->arity();
+                    }
+
+                template <typename M>
+                    unsigned int arity(M, long) {
+                        return 2;
+                    }
+
+                template <typename E, typename C>
+                    auto reserve(E* env, C**& pool, unsigned int count,
+                            Random& random, int) -> decltype(env->reserve(pool, count, random), void()) {
+                        env->reserve(pool, count, random);
+                    }
+
+                template <typename E, typename C>
+                    void reserve(E* env, C**& pool, unsigned int count, Random&, long) {
+                        env->reserve(pool, count);
+                    }
+
+                template <typename E, typename C>
+                    auto evaluate(E* env, const C* candidate,
+                            Random& random, int) -> decltype(env->evaluate(candidate, random)) {
+                        return env->evaluate(candidate, random);
+                    }
+
+                template <typename E, typename C>
+                    double evaluate(E* env, const C* candidate, Random&, long) {
+                        return env->evaluate(candidate);
+                    }
+
+                template <typename E, typename C>
+                    auto delta(E* env, const C* offspring, const C* parent, double score,
+                            const Changes& changes, Random&, int)
+                    -> decltype(env->evaluateDelta(offspring, parent, score, changes)) {
+                        return env->evaluateDelta(offspring, parent, score, changes);
+                    }
+
+                template <typename E, typename C>
+                    double delta(E* env, const C* offspring, const C*, double, const Changes&,
+                            Random& random, long) {
+                        return evaluate(env, offspring, random, 0);
+                    }
+
+                template <typename E, typename C>
+                    auto deltable(E* env, const C* candidate, int)
+                    -> decltype(env->evaluateDelta(candidate, candidate, 0.0, std::declval<const Changes&>()),
+                            std::true_type());
+
+                template <typename E, typename C>
+                    std::false_type deltable(E*, const C*, long);
+
+                /**
+                 * 'std::true_type' if the environment evaluates offspring out of
+                 * their parent:
+                 *     double evaluateDelta(const C* offspring, const C* parent,
+                 *         double parentScore, const Changes& changes)
+                 */
+                template <typename E, typename C> struct Delta :
+                    decltype(deltable(static_cast<E*>(nullptr), static_cast<const C*>(nullptr), 0)) {};
+
+                template <typename E, typename C>
+                    auto evaluate(E* env, const C* candidate, double* objectives,
+                            Random& random, int) -> decltype(env->evaluate(candidate, objectives, random), void()) {
+                        env->evaluate(candidate, objectives, random);
+                    }
+
+                template <typename E, typename C>
+                    void evaluate(E* env, const C* candidate, double* objectives, Random&, long) {
+                        env->evaluate(candidate, objectives);
+                    }
+
+                template <typename E, typename C>
+                    auto batchable(E* env, const C* const* candidates, int)
+                    -> decltype(env->evaluate(candidates, 0u, static_cast<double*>(nullptr)), std::true_type());
+
+                template <typename E, typename C>
+                    std::false_type batchable(E*, const C* const*, long);
+
+                /**
+                 * 'std::true_type' if the environment evaluates batches:
+                 *     void evaluate(const C* const* candidates, unsigned int count, double* scores)
+                 */
+                template <typename E, typename C> struct Batch :
+                    decltype(batchable(static_cast<E*>(nullptr), static_cast<const C* const*>(nullptr), 0)) {};
+
+                /**
+                 * Evaluate a batch, split in one chunk per thread.
+                 * @param env Environment, implementing the batch evaluation.
+                 * @param candidates Candidates.
+                 * @param count Number of candidates.
+                 * @param scores Receives the scores.
+                 * @param time If not null, time spent by each thread is added
+                 * to it, in nanoseconds.
+                 */
+                template <typename E, typename C>
+                    void batch(E* env, const C* const* candidates, unsigned int count, double* scores,
+                            std::uint64_t* time = nullptr) {
+                        if(0 == count) {
+                            return;
+                        }
+                        unsigned int threads = Parallel::count();
+                        unsigned int chunk = (count + threads - 1) / threads;
+                        unsigned int chunks = (count + chunk - 1) / chunk;
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < chunks; ++i) {
+                            unsigned int first = i * chunk;
+                            unsigned int size = count - first < chunk ? count - first : chunk;
+                            std::uint64_t begin = nullptr != time ? Parallel::now() : 0;
+                            env->evaluate(candidates + first, size, scores + first);
+                            if(nullptr != time) {
+                                time[Parallel::index()] += Parallel::now() - begin;
+                            }
+                        }
+                    }
+            } // Namespace 'Concept'
+
+            /**
+             * Raw binary I/O of plain values, in native byte order.
+             */
+            namespace Binary {
+                template <typename T> void write(std::ostream& out, const T* values, std::size_t count = 1) {
+                    out.write(reinterpret_cast<const char*>(values), sizeof(T) * count);
+                }
+
+                template <typename T> bool read(std::istream& in, T* values, std::size_t count = 1) {
+                    in.read(reinterpret_cast<char*>(values), sizeof(T) * count);
+                    return in.good();
+                }
+            } // Namespace 'Binary'
+
+            /**
+             * Alias table (Vose) for O(1) weighted drawing.
+             */
+            class AliasTable {
+                public:
+                    AliasTable() : _probability(nullptr), _alias(nullptr), _work(nullptr),
+                        _count(0), _capacity(0) {}
+
+                    ~AliasTable() {
+                        delete []_probability;
+                        delete []_alias;
+                        delete []_work;
+                    }
+
+                    /**
+                     * Build the table. O(count).
+                     * @param weights Non-negative weights. If they are all null,
+                     * drawing is uniform.
+                     * @param count Number of weights.
+                     */
+                    void build(const double* weights, unsigned int count) {
+                        if(count > _capacity) {
+                            delete []_probability;
+                            delete []_alias;
+                            delete []_work;
+                            _probability = new double[count];
+                            _alias = new unsigned int[count];
+                            _work = new unsigned int[count];
+                            _capacity = count;
+                        }
+                        _count = count;
+                        double total = 0.0;
+                        for(unsigned int i = 0; i < count; ++i) {
+                            total += weights[i];
+                        }
+                        // Small ones from the start of the work list, large ones
+                        // from its end.
+                        unsigned int small = 0;
+                        unsigned int large = count;
+                        for(unsigned int i = 0; i < count; ++i) {
+                            _probability[i] = total > 0.0 ? weights[i] * count / total : 1.0;
+                            _alias[i] = i;
+                            if(_probability[i] < 1.0) {
+                                _work[small++] = i;
+                            } else {
+                                _work[--large] = i;
+                            }
+                        }
+                        unsigned int s = 0;
+                        while(s < small && large < count) {
+                            unsigned int less = _work[s++];
+                            unsigned int more = _work[large];
+                            _alias[less] = more;
+                            _probability[more] -= 1.0 - _probability[less];
+                            if(_probability[more] < 1.0) {
+                                // Becomes small: reuse the slot we consumed.
+                                ++large;
+                                _work[--s] = more;
+                            }
+                        }
+                        for(; s < small; ++s) {
+                            _probability[_work[s]] = 1.0;
+                        }
+                        for(; large < count; ++large) {
+                            _probability[_work[large]] = 1.0;
+                        }
+                    }
+
+                    /**
+                     * Draw an index, out of a single random number: its integer
+                     * part picks the column, its fractional part the side.
+                     * @param random Random stream.
+                     * @return Index in [0, count).
+                     */
+                    unsigned int draw(Random& random) const {
+                        double position = random.uniform() * _count;
+                        unsigned int column = static_cast<unsigned int>(position);
+                        column = column < _count ? column : _count - 1;
+                        return position - column < _probability[column] ? column : _alias[column];
+                    }
+
+                private:
+                    AliasTable(const AliasTable&);
+                    AliasTable& operator=(const AliasTable&);
+
+                private:
+                    double*       _probability;
+                    unsigned int* _alias;
+                    unsigned int* _work;
+                    unsigned int  _count;
+                    unsigned int  _capacity;
+            };
+
+            /**
+             * Truncation selection.
+             * The elite is extracted in O(n + k log k) (partial selection then
+             * sort of the elite only) and parents are drawn uniformly among it.
+             *
+             * A selection policy must define the following methods:
+             * - void rank(const double* score, unsigned int* order,
+             *       unsigned int count, unsigned int elite)
+             *   Order candidate indices so that the 'elite' best ones come
+             *   first, sorted by increasing score.
+             * - void prepare(const double* score, unsigned int count, unsigned int elite)
+             *   Called once the pool follows that order, before parent drawing.
+             * - unsigned int select(Random&) const
+             *   Draw a parent index. Must be thread-safe.
+             */
+            class Truncation {
+                public:
+                    Truncation() : _elite(1) {}
+
+                    void rank(const double* score, unsigned int* order,
+                            unsigned int count, unsigned int elite) {
+                        for(unsigned int i = 0; i < count; ++i) {
+                            order[i] = i;
+                        }
+                        Compare compare(score);
+                        if(elite < count) {
+                            std::nth_element(order, order + elite, order + count, compare);
+                        }
+                        std::sort(order, order + elite, compare);
+                    }
+
+                    void prepare(const double*, unsigned int, unsigned int elite) {
+                        _elite = elite;
+                    }
+
+                    unsigned int select(Random& random) const {
+                        return random.below(_elite);
+                    }
+
+                protected:
+                    /**
+                     * Index comparison by score. Ties are broken by index so that
+                     * the order is fully deterministic.
+                     */
+                    class Compare {
+                        public:
+                            Compare(const double* score) : _score(score) {}
+                            bool operator()(unsigned int a, unsigned int b) const {
+                                return _score[a] < _score[b] || (_score[a] == _score[b] && a < b);
+                            }
+                        private:
+                            const double* _score;
+                    };
+
+                private:
+                    unsigned int _elite;
+            };
+
+            /**
+             * Tournament selection.
+             * Each parent is the best of 'K' candidates drawn uniformly in the
+             * whole pool. Elite extraction as for 'Truncation'.
+             * @param <K> Tournament size.
+             */
+            template <unsigned int K> class Tournament : public Truncation {
+                public:
+                    Tournament() : _score(nullptr), _count(0) {}
+
+                    void prepare(const double* score, unsigned int count, unsigned int) {
+                        _score = score;
+                        _count = count;
+                    }
+
+                    unsigned int select(Random& random) const {
+                        unsigned int best = random.below(_count);
+                        for(unsigned int i = 1; i < K; ++i) {
+                            unsigned int challenger = random.below(_count);
+                            if(_score[challenger] < _score[best]) {
+                                best = challenger;
+                            }
+                        }
+                        return best;
+                    }
+
+                private:
+                    const double* _score;
+                    unsigned int  _count;
+            };
+
+            /**
+             * Linear rank selection.
+             * The candidate at rank 'i' (0 being the best) is drawn with a
+             * probability proportional to 'count - i'. Ranking requires a full
+             * sort: O(n log n).
+             */
+            class Rank : public Truncation {
+                public:
+                    Rank() : _count(0) {}
+
+                    void rank(const double* score, unsigned int* order,
+                            unsigned int count, unsigned int) {
+                        Truncation::rank(score, order, count, count);
+                    }
+
+                    void prepare(const double*, unsigned int count, unsigned int) {
+                        _count = count;
+                    }
+
+                    unsigned int select(Random& random) const {
+                        // Inverse of the (continuous) cumulative distribution.
+                        double position = _count * (1.0 - std::sqrt(1.0 - random.uniform()));
+                        unsigned int index = static_cast<unsigned int>(position);
+                        return index < _count ? index : _count - 1;
+                    }
+
+                private:
+                    unsigned int _count;
+            };
+
+            /**
+             * Roulette wheel selection.
+             * Candidates are drawn with a probability proportional to their
+             * distance to the worst score (plus a small offset so that the worst
+             * can still be drawn) through an alias table: O(n) to build, O(1)
+             * per parent. Elite extraction as for 'Truncation'.
+             * Non-finite scores (e.g. failed evaluations) are clamped to the
+             * finite range: NaN and +inf count as the worst, -inf as the best.
+             */
+            class Roulette : public Truncation {
+                public:
+                    Roulette() : _weights(nullptr), _capacity(0) {}
+
+                    ~Roulette() {
+                        delete []_weights;
+                    }
+
+                    void prepare(const double* score, unsigned int count, unsigned int) {
+                        if(count > _capacity) {
+                            delete []_weights;
+                            _weights = new double[count];
+                            _capacity = count;
+                        }
+                        double best = std::numeric_limits<double>::infinity();
+                        double worst = -best;
+                        for(unsigned int i = 0; i < count; ++i) {
+                            if(std::isfinite(score[i])) {
+                                worst = score[i] > worst ? score[i] : worst;
+                                best = score[i] < best ? score[i] : best;
+                            }
+                        }
+                        if(best > worst) {
+                            // Nothing finite: uniform drawing.
+                            best = worst = 0.0;
+                        }
+                        double offset = (worst - best) / count;
+                        for(unsigned int i = 0; i < count; ++i) {
+                            double value = score[i] < best ? best : (score[i] <= worst ? score[i] : worst);
+                            _weights[i] = worst - value + offset;
+                        }
+                        _table.build(_weights, count);
+                    }
+
+                    unsigned int select(Random& random) const {
+                        return _table.draw(random);
+                    }
+
+                private:
+                    Roulette(const Roulette&);
+                    Roulette& operator=(const Roulette&);
+
+                private:
+                    double*      _weights;
+                    unsigned int _capacity;
+                    AliasTable   _table;
+            };
+
+            /**
+             * Fixed operator scheduling: each mutator is tried in turn with its
+             * threshold probability, the last one being the fallback. Effective
+             * probabilities thus depend on the mutators order.
+             *
+             * An operator scheduler must define the following methods:
+             * - void start(unsigned int operators)
+             *   Called before training with the number of mutators.
+             * - unsigned int choose(Random&, M... mutators) const
+             *   Index of the mutator to apply. Must be thread-safe.
+             * - void reward(unsigned int index, bool success)
+             *   Outcome of an offspring of the mutator: 'true' if it scores
+             *   better than its best parent.
+             * - void update()
+             *   Called once per generation, after the rewards.
+             * - void write(std::ostream&) const
+             *   bool read(std::istream&)
+             *   Save and restore the learnt state, for checkpoints. Called
+             *   right after 'update'.
+             */
+            class Cascade {
+                public:
+                    void start(unsigned int) {}
+
+                    template <typename M> unsigned int choose(Random&, M) const {
+                        return 0;
+                    }
+
+                    template <typename M, typename... O> unsigned int choose(Random& random,
+                            M mutator, O... others) const {
+                        if(random.uniform() < mutator->threshold()) {
+                            return 0;
+                        }
+                        return 1 + choose(random, others...);
+                    }
+
+                    void reward(unsigned int, bool) {}
+
+                    void update() {}
+
+                    void write(std::ostream&) const {}
+
+                    bool read(std::istream&) { return true; }
+            };
+
+            /**
+             * Adaptive operator scheduling by probability matching.
+             * The quality of each mutator follows its success rate (offspring
+             * better than their best parent) with an exponential moving average,
+             * and mutators are chosen with a probability proportional to their
+             * quality, never below a minimal one so that none is starved.
+             * Probabilities are turned into an alias table once per generation:
+             * choosing costs a single random draw. Thresholds are ignored.
+             */
+            class Adaptive {
+                public:
+                    /**
+                     * Constructor.
+                     * @param minimum Minimal probability of each mutator. Must be
+                     * below 1 / number of mutators.
+                     * @param rate Adaptation rate, in ]0, 1].
+                     */
+                    Adaptive(double minimum = 0.05, double rate = 0.3) : _minimum(minimum), _rate(rate),
+                        _quality(nullptr), _probability(nullptr), _trials(nullptr), _successes(nullptr),
+                        _count(0) {}
+
+                    ~Adaptive() {
+                        release();
+                    }
+
+                    void start(unsigned int operators) {
+                        release();
+                        _count = operators;
+                        _quality = new double[operators];
+                        _probability = new double[operators];
+                        _trials = new unsigned int[operators];
+                        _successes = new unsigned int[operators];
+                        for(unsigned int i = 0; i < operators; ++i) {
+                            _quality[i] = 1.0;
+                            _probability[i] = 1.0 / operators;
+                            _trials[i] = 0;
+                            _successes[i] = 0;
+                        }
+                        _table.build(_probability, operators);
+                    }
+
+                    template <typename... M> unsigned int choose(Random& random, M...) const {
+                        return _table.draw(random);
+                    }
+
+                    void reward(unsigned int index, bool success) {
+                        ++_trials[index];
+                        _successes[index] += success ? 1 : 0;
+                    }
+
+                    void update() {
+                        double total = 0.0;
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_trials[i] > 0) {
+                                double rate = static_cast<double>(_successes[i]) / _trials[i];
+                                _quality[i] += _rate * (rate - _quality[i]);
+                            }
+                            _trials[i] = 0;
+                            _successes[i] = 0;
+                            total += _quality[i];
+                        }
+                        double share = 1.0 - _count * _minimum;
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _probability[i] = _minimum + share * (total > 0.0 ? _quality[i] / total : 1.0 / _count);
+                        }
+                        _table.build(_probability, _count);
+                    }
+
+                    /**
+                     * @param index Mutator index.
+                     * @return Current probability of the mutator.
+                     */
+                    double probability(unsigned int index) const { return _probability[index]; }
+
+                    void write(std::ostream& out) const {
+                        Binary::write(out, &_count);
+                        Binary::write(out, _quality, _count);
+                        Binary::write(out, _probability, _count);
+                    }
+
+                    bool read(std::istream& in) {
+                        unsigned int count;
+                        if(!Binary::read(in, &count)) {
+                            return false;
+                        }
+                        start(count);
+                        if(!Binary::read(in, _quality, count) || !Binary::read(in, _probability, count)) {
+                            return false;
+                        }
+                        _table.build(_probability, count);
+                        return true;
+                    }
+
+                private:
+                    Adaptive(const Adaptive&);
+                    Adaptive& operator=(const Adaptive&);
+
+                    void release() {
+                        delete []_quality;
+                        delete []_probability;
+                        delete []_trials;
+                        delete []_successes;
+                    }
+
+                private:
+                    double        _minimum;
+                    double        _rate;
+                    double*       _quality;
+                    double*       _probability;
+                    unsigned int* _trials;
+                    unsigned int* _successes;
+                    unsigned int  _count;
+                    AliasTable    _table;
+            };
+
+            /**
+             * Offspring creation, shared by the engines.
+             */
+            namespace Breeding {
+                /**
+                 * Select parents and apply a mutator.
+                 * @param pool Ranked pool.
+                 * @param score Pool scores.
+                 * @param selection Prepared selection policy.
+                 * @param offspring Candidate to overwrite.
+                 * @param random Random stream.
+                 * @param changes If not null, receives the first parent index
+                 * and the changes the mutator reports, if it does.
+                 * @param mutator Mutator.
+                 * @return Best parent score.
+                 */
+                template <typename C, typename S, typename M> double breed(C** pool, const double* score,
+                        const S& selection, C* offspring, Random& random, Changes* changes, M mutator) {
+                    unsigned int arity = Concept::arity(mutator, 0);
+                    arity = arity > GA_MAX_ARITY ? GA_MAX_ARITY : arity;
+                    C* parents[GA_MAX_ARITY];
+                    Changes ignored;
+                    Changes& record = nullptr != changes ? *changes : ignored;
+                    record.clear();
+                    double best = 0.0;
+                    for(unsigned int i = 0; i < arity; ++i) {
+                        unsigned int index = selection.select(random);
+                        parents[i] = pool[index];
+                        best = (0 == i || score[index] < best) ? score[index] : best;
+                        record.parent = 0 == i ? index : record.parent;
+                    }
+                    if(0 == arity) {
+                        record.parent = 0;
+                        record.forget();
+                    }
+                    Concept::mutate(mutator, parents, arity, offspring, random, record, 0);
+                    return best;
+                }
+
+                /**
+                 * Apply the mutator of the specified index.
+                 * @return Best parent score.
+                 */
+                template <typename C, typename S, typename M> double apply(unsigned int, C** pool,
+                        const double* score, const S& selection, C* offspring, Random& random,
+                        Changes* changes, M mutator) {
+                    return breed(pool, score, selection, offspring, random, changes, mutator);
+                }
+
+                template <typename C, typename S, typename M, typename... O> double apply(unsigned int index,
+                        C** pool, const double* score, const S& selection, C* offspring, Random& random,
+                        Changes* changes, M mutator, O... others) {
+                    if(0 == index) {
+                        return breed(pool, score, selection, offspring, random, changes, mutator);
+                    }
+                    return apply(index - 1, pool, score, selection, offspring, random, changes, others...);
+                }
+
+                /**
+                 * make a new offspring out of the available mutators, chosen by
+                 * a 'Cascade'.
+                 * @return Best parent score.
+                 */
+                template <typename C, typename S, typename... M> double mutate(C** pool,
+                        const double* score, const S& selection, C* offspring, Random& random,
+                        M... mutators) {
+                    unsigned int index = Cascade().choose(random, mutators...);
+                    return apply(index, pool, score, selection, offspring, random,
+                            static_cast<Changes*>(nullptr), mutators...);
+                }
+            } // Namespace 'Breeding'
+
+            /**
+             * Compile-time list of stages run on each offspring right after
+             * it is bred, in the same parallel loop (see 'Trivial::reproduce').
+             * With an 'Evaluation' stage, offspring are evaluated while still
+             * hot in cache, instead of in a second pass over the whole pool.
+             *
+             * A stage must define the following method, called concurrently:
+             * - void apply(E* env, O& offspring) const
+             *   where 'O' is the engine offspring view (see 'Trivial::Offspring').
+             * Stages run in order. A stage modifying the genome must record
+             * the genes it changes, or forget them, for delta evaluation.
+             * @param <... S> Stages.
+             */
+            template <typename... S> class Pipeline {
+                public:
+                    /**
+                     * Constructor, for default constructible stages.
+                     */
+                    Pipeline() {}
+
+                    /**
+                     * Constructor.
+                     * @param stages Stages, in order.
+                     */
+                    template <typename... T> explicit Pipeline(T... stages) : _stages(stages...) {}
+
+                    /**
+                     * Run the stages on an offspring.
+                     */
+                    template <typename E, typename O> void run(E* env, O& offspring) const {
+                        run<0>(env, offspring, std::integral_constant<bool, 0 < sizeof...(S)>());
+                    }
+
+                private:
+                    template <std::size_t I, typename E, typename O> void run(E* env, O& offspring,
+                            std::true_type) const {
+                        std::get<I>(_stages).apply(env, offspring);
+                        run<I + 1>(env, offspring, std::integral_constant<bool, I + 1 < sizeof...(S)>());
+                    }
+
+                    template <std::size_t I, typename E, typename O> void run(E*, O&, std::false_type) const {}
+
+                private:
+                    std::tuple<S...> _stages;
+            };
+
+            /**
+             * Pipeline stage: evaluate the offspring (memo table and delta
+             * evaluation included), as the engine would have done at the
+             * next generation.
+             */
+            class Evaluation {
+                public:
+                    template <typename E, typename O> void apply(E* env, O& offspring) const {
+                        offspring.evaluate(env);
+                    }
+            };
+
+            /**
+             * Pipeline stage: apply a mutator to the offspring, in place, with
+             * a given probability. It follows the mutator drawn by the engine,
+             * e.g. a mutation after a crossover. The mutator gets the offspring
+             * as its only parent and as its result: it must support it, and be
+             * thread-safe.
+             * @param <M> Mutator, as handed to the engine.
+             */
+            template <typename M> class Mutation {
+                public:
+                    /**
+                     * @param mutator Mutator.
+                     * @param rate Application probability.
+                     */
+                    Mutation(M mutator, double rate = 1.0) : _mutator(mutator), _rate(rate) {}
+
+                    template <typename E, typename O> void apply(E*, O& offspring) const {
+                        Random& random = offspring.random();
+                        if(_rate < 1.0 && random.uniform() >= _rate) {
+                            return;
+                        }
+                        auto genome = offspring.genome();
+                        Changes changes;
+                        Concept::mutate(_mutator, &genome, 1, genome, random, changes, 0);
+                        Changes& recorded = offspring.changes();
+                        if(!changes.known()) {
+                            recorded.forget();
+                        }
+                        // Genes changed twice are reported once.
+                        for(unsigned int i = 0; i < changes.size() && recorded.known(); ++i) {
+                            bool found = false;
+                            for(unsigned int j = 0; j < recorded.size() && !found; ++j) {
+                                found = recorded[j] == changes[i];
+                            }
+                            if(!found) {
+                                recorded.add(changes[i]);
+                            }
+                        }
+                    }
+
+                private:
+                    M      _mutator;
+                    double _rate;
+            };
+
+            /**
+             * Null memo table. Nothing is ever remembered.
+             */
+            class NoMemo {
+                public:
+                    template <typename C> bool lookup(const C*, std::size_t&, double&) const {
+                        return false;
+                    }
+                    template <typename E, typename C> void store(E*, const C*, std::size_t, double) {}
+                    template <typename E> void clear(E*) {}
+                    template <typename W> void write(std::ostream&, W*) const {}
+                    template <typename E, typename W> bool read(std::istream&, E*, W*) { return true; }
+            };
+
+            /**
+             * Bounded genome memo table.
+             * Scores of already evaluated genomes are remembered so that duplicates
+             * produced by the mutators are not evaluated again. The table is
+             * direct-mapped: a new genome evicts the one stored in its slot.
+             * Genomes are stored as clones made by the environment.
+             * Lookups are thread-safe; storage is not.
+             * @param <C> Candidate.
+             * @param <H> Hashing concept. Must implement:
+             *     - std::size_t hash(const C*) const
+             *     - bool equals(const C*, const C*) const
+             * @param <N> Number of slots.
+             */
+            template <typename C, typename H, unsigned int N> class Memo {
+                public:
+                    Memo() : _genome(new C*[N]), _hash(new std::size_t[N]),
+                        _score(new double[N]) {
+                        for(unsigned int i = 0; i < N; ++i) {
+                            _genome[i] = nullptr;
+                        }
+                    }
+
+                    ~Memo() {
+                        delete []_genome;
+                        delete []_hash;
+                        delete []_score;
+                    }
+
+                    /**
+                     * Look for a genome.
+                     * @param candidate Candidate.
+                     * @param hash Storage for the candidate hash.
+                     * @param score Storage for the score, if found.
+                     * @return 'true' if found.
+                     */
+                    bool lookup(const C* candidate, std::size_t& hash, double& score) const {
+                        hash = _hasher.hash(candidate);
+                        unsigned int slot = hash % N;
+                        if(nullptr != _genome[slot] && _hash[slot] == hash &&
+                                _hasher.equals(_genome[slot], candidate)) {
+                            score = _score[slot];
+                            return true;
+                        }
+                        return false;
+                    }
+
+                    /**
+                     * Remember a genome score.
+                     * @param env Environment, used to clone and release genomes.
+                     * @param candidate Candidate.
+                     * @param hash Candidate hash, as given by 'lookup'.
+                     * @param score Candidate score.
+                     */
+                    template <typename E> void store(E* env, const C* candidate, std::size_t hash, double score) {
+                        unsigned int slot = hash % N;
+                        if(nullptr != _genome[slot]) {
+                            env->release(_genome + slot, 1);
+                        }
+                        _genome[slot] = env->clone(candidate);
+                        _hash[slot] = hash;
+                        _score[slot] = score;
+                    }
+
+                    /**
+                     * Forget everything.
+                     * @param env Environment, used to release genomes.
+                     */
+                    template <typename E> void clear(E* env) {
+                        for(unsigned int i = 0; i < N; ++i) {
+                            if(nullptr != _genome[i]) {
+                                env->release(_genome + i, 1);
+                                _genome[i] = nullptr;
+                            }
+                        }
+                    }
+
+                    /**
+                     * @return Hashing concept instance.
+                     */
+                    H& hasher() { return _hasher; }
+
+                    /**
+                     * Save the table, for checkpoints.
+                     * @param out Output stream.
+                     * @param serializer Genome serializer (see 'Trivial::checkpoint').
+                     */
+                    template <typename W> void write(std::ostream& out, W* serializer) const {
+                        for(unsigned int i = 0; i < N; ++i) {
+                            char present = nullptr != _genome[i] ? 1 : 0;
+                            Binary::write(out, &present);
+                            if(present) {
+                                Binary::write(out, _hash + i);
+                                Binary::write(out, _score + i);
+                                serializer->write(out, static_cast<const C*>(_genome[i]));
+                            }
+                        }
+                    }
+
+                    /**
+                     * Restore the table. The current content is forgotten.
+                     * @param in Input stream.
+                     * @param env Environment, used to allocate and release genomes.
+                     * @param serializer Genome serializer.
+                     * @return 'false' on read failure.
+                     */
+                    template <typename E, typename W> bool read(std::istream& in, E* env, W* serializer) {
+                        clear(env);
+                        for(unsigned int i = 0; i < N; ++i) {
+                            char present;
+                            if(!Binary::read(in, &present)) {
+                                return false;
+                            }
+                            if(present) {
+                                if(!Binary::read(in, _hash + i) || !Binary::read(in, _score + i)) {
+                                    return false;
+                                }
+                                C** genome = _genome + i;
+                                Random random(0, 0, i, Random::INITIALIZATION);
+                                Concept::reserve(env, genome, 1, random, 0);
+                                serializer->read(in, _genome[i]);
+                            }
+                        }
+                        return in.good();
+                    }
+
+                private:
+                    Memo(const Memo&);
+                    Memo& operator=(const Memo&);
+
+                private:
+                    /** Hashing concept. */
+                    H            _hasher;
+                    /** Stored genomes. */
+                    C**          _genome;
+                    /** Genome hashes. */
+                    std::size_t* _hash;
+                    /** Genome scores. */
+                    double*      _score;
+            };
+
+            /**
+             * Null surrogate. All offspring are evaluated.
+             *
+             * A surrogate must define the following:
+             * - static const bool enabled
+             *   'false' compiles screening out.
+             * - bool ready() const
+             *   Whether predictions can be made.
+             * - double ratio() const
+             *   Fraction of the offspring of a generation to evaluate.
+             * - double predict(const C*) const
+             *   Approximate score. Must be thread-safe.
+             * - void learn(E* env, const C*, double score)
+             *   Record a true score.
+             * - void clear(E* env)
+             *   Forget everything.
+             */
+            class NoSurrogate {
+                public:
+                    static const bool enabled = false;
+                    bool ready() const { return false; }
+                    double ratio() const { return 1.0; }
+                    template <typename C> double predict(const C*) const { return 0.0; }
+                    template <typename E, typename C> void learn(E*, const C*, double) {}
+                    template <typename E> void clear(E*) {}
+            };
+
+            /**
+             * No niching. Candidates are ranked on their scores.
+             *
+             * A niching policy must define the following:
+             * - static const bool enabled
+             *   'false' compiles niching out.
+             * - void adjust(E* env, const C* const* pool, const double* scores,
+             *       double* fitness, unsigned int count)
+             *   Compute the fitness the whole pool is ranked and selected on,
+             *   out of its scores. Called once per generation.
+             * - void clear(E* env)
+             *   Forget everything.
+             */
+            class NoNiching {
+                public:
+                    static const bool enabled = false;
+                    template <typename E, typename C> void adjust(E*, const C* const*, const double*,
+                            double*, unsigned int) {}
+                    template <typename E> void clear(E*) {}
+            };
+
+            /**
+             * K-nearest-neighbour surrogate.
+             * The last 'N' evaluated genomes are kept (as clones made by the
+             * environment) and a genome is predicted the inverse distance
+             * weighted mean score of its 'K' nearest ones. Prediction is a
+             * linear scan of the archive: it must stay far cheaper than an
+             * evaluation.
+             * @param <C> Candidate.
+             * @param <D> Distance concept. Must implement:
+             *     - double distance(const C*, const C*) const
+             * @param <K> Number of neighbours.
+             * @param <N> Archive size.
+             */
+            template <typename C, typename D, unsigned int K = 8, unsigned int N = 1024> class Nearest {
+                public:
+                    static const bool enabled = true;
+
+                    Nearest() : _genome(new C*[N]), _score(new double[N]), _size(0), _next(0),
+                        _ratio(0.5) {}
+
+                    ~Nearest() {
+                        delete []_genome;
+                        delete []_score;
+                    }
+
+                    /**
+                     * @return Distance concept instance.
+                     */
+                    D& distance() { return _distance; }
+
+                    /**
+                     * @return Fraction of the offspring of a generation that are
+                     * evaluated, the ones with the best predictions. 0.5 by default.
+                     */
+                    double& ratio() { return _ratio; }
+                    double ratio() const { return _ratio; }
+
+                    bool ready() const { return _size >= K; }
+
+                    double predict(const C* candidate) const {
+                        // Nearest neighbours, sorted by increasing distance.
+                        double distance[K];
+                        unsigned int index[K];
+                        unsigned int found = 0;
+                        for(unsigned int i = 0; i < _size; ++i) {
+                            double current = _distance.distance(candidate, _genome[i]);
+                            if(found == K && current >= distance[K - 1]) {
+                                continue;
+                            }
+                            unsigned int position = found < K ? found++ : K - 1;
+                            for(; position > 0 && current < distance[position - 1]; --position) {
+                                distance[position] = distance[position - 1];
+                                index[position] = index[position - 1];
+                            }
+                            distance[position] = current;
+                            index[position] = i;
+                        }
+                        if(0 == found) {
+                            return 0.0;
+                        }
+                        if(distance[0] <= 0.0) {
+                            return _score[index[0]];
+                        }
+                        double sum = 0.0;
+                        double weights = 0.0;
+                        for(unsigned int i = 0; i < found; ++i) {
+                            sum += _score[index[i]] / distance[i];
+                            weights += 1.0 / distance[i];
+                        }
+                        return sum / weights;
+                    }
+
+                    /**
+                     * Record a score, in place of the oldest one if full.
+                     * @param env Environment, used to clone and release genomes.
+                     */
+                    template <typename E> void learn(E* env, const C* candidate, double score) {
+                        if(_size == N) {
+                            env->release(_genome + _next, 1);
+                        } else {
+                            ++_size;
+                        }
+                        _genome[_next] = env->clone(candidate);
+                        _score[_next] = score;
+                        _next = (_next + 1) % N;
+                    }
+
+                    /**
+                     * Forget everything.
+                     * @param env Environment, used to release genomes.
+                     */
+                    template <typename E> void clear(E* env) {
+                        env->release(_genome, _size);
+                        _size = 0;
+                        _next = 0;
+                    }
+
+                private:
+                    Nearest(const Nearest&);
+                    Nearest& operator=(const Nearest&);
+
+                private:
+                    /** Distance concept. */
+                    D            _distance;
+                    /** Archived genomes. */
+                    C**          _genome;
+                    /** Their scores. */
+                    double*      _score;
+                    /** Number of archived genomes. */
+                    unsigned int _size;
+                    /** Next slot to write. */
+                    unsigned int _next;
+                    /** Evaluated fraction. */
+                    double       _ratio;
+            };
+
+            /**
+             * Additional stop and restart criteria. Null values disable them.
+             */
+            struct Criteria {
+                Criteria() : seconds(0.0), evaluations(0), window(0), tolerance(0.0),
+                    restart(0.0), collapse(0.0) {}
+
+                /** Wall clock budget, in seconds. */
+                double             seconds;
+                /** Evaluation budget (memo hits are free). */
+                unsigned long long evaluations;
+                /** Stop when the best score didn't improve during that many generations. */
+                unsigned int       window;
+                /** Improvements up to this value don't count as such. */
+                double             tolerance;
+                /**
+                 * Fraction of the pool replaced by new candidates when the
+                 * diversity collapses, i.e. when the mean score is within
+                 * 'collapse' of the best one.
+                 */
+                double             restart;
+                /** Diversity collapse threshold. */
+                double             collapse;
+            };
+
+            /**
+             * Training progress, handed to the per-generation callback.
+             * @param <C> Candidate.
+             */
+            template <typename C> struct Progress {
+                /** Generation number. */
+                unsigned int       generation;
+                /** Number of evaluations so far. */
+                unsigned long long evaluations;
+                /** Elapsed time, in seconds. */
+                double             seconds;
+                /** Ranked elite. Valid during the call only: clone to keep. */
+                const C* const*    elite;
+                /** Elite scores. */
+                const double*      scores;
+                /** Elite size. */
+                unsigned int       count;
+            };
+
+            /**
+             * Per-generation telemetry, handed to observers.
+             */
+            struct Telemetry {
+                /** Generation number. */
+                unsigned int         generation;
+                /** Best score. */
+                double               best;
+                /** Mean score. */
+                double               mean;
+                /** Worst score. */
+                double               worst;
+                /** Standard deviation of the scores, as a cheap diversity estimate. */
+                double               deviation;
+                /** Number of evaluations of the generation (memo hits are free). */
+                unsigned int         evaluations;
+                /** Number of threads, i.e. of entries of the time arrays. */
+                unsigned int         threads;
+                /** Time spent in evaluation by each thread, in nanoseconds. */
+                const std::uint64_t* evaluation;
+                /**
+                 * Time spent breeding this generation by each thread (parent
+                 * drawing and mutators), in nanoseconds.
+                 */
+                const std::uint64_t* mutation;
+                /** Time spent ranking and preparing the selection, in nanoseconds. */
+                std::uint64_t        selection;
+            };
+
+            /**
+             * Null observer. Nothing is measured: it costs nothing.
+             *
+             * An observer must define the following:
+             * - static const bool enabled
+             *   'false' compiles telemetry out.
+             * - void observe(const Telemetry&)
+             *   Called at the end of each evaluation.
+             */
+            class NullObserver {
+                public:
+                    static const bool enabled = false;
+                    void observe(const Telemetry&) {}
+            };
+
+            /**
+             * Trivial GA.
+             * 1. Generate first pool.
+             * 2. Evaluate pool against a testing environment.
+             * 3. Save the elite.
+             * 4. Create new pool from elite using set of operators.
+             * 5. Back to step 2 until error is superior to specified
+             *    or until generation number is inferior to specified.
+             *
+             * Random numbers come from 'Random' streams bound to the seed, the
+             * generation and the candidate index: for a given seed, results are
+             * identical whatever the number of threads.
+             *
+             * Only candidates modified since their last evaluation are evaluated
+             * again, so the elite is not re-scored at each generation. A memo table
+             * can moreover remember the scores of already seen genomes.
+             *
+             * Parents are chosen by the selection policy and handed to the
+             * mutators. Offspring are written in a second buffer, so that
+             * parents can be drawn from the whole pool. Mutators are chosen by
+             * the operator scheduler, which is told whether their offspring
+             * beat their parents.
+             *
+             * To this purpose, we need the following concepts :
+             * @param <C> Candidates to be evaluated and modified.
+             * @param <H> Memo table. 'NoMemo' or 'Memo'.
+             * @param <S> Selection policy. 'Truncation', 'Tournament', 'Rank'
+             *     or 'Roulette'.
+             * @param <A> Operator scheduler. 'Cascade' or 'Adaptive'.
+             * @param <O> Observer, receiving per-generation telemetry.
+             *     'NullObserver' by default.
+             * @param <R> Surrogate. With 'Nearest', offspring are first given a
+             *     predicted score and only the most promising ones are
+             *     evaluated; the others keep their prediction, and are
+             *     evaluated if they make it to the next generation. Initial,
+             *     immigrant and restarted candidates are always evaluated.
+             *     'NoSurrogate' by default.
+             * @param <N> Niching policy. With 'Novelty' (see
+             *     'geneticalgorithmnovelty.hpp'), the pool is ranked and
+             *     selected on a fitness mixing scores with novelty or fitness
+             *     sharing; scores stay the plain ones (memo, surrogate, delta
+             *     evaluation, results). 'NoNiching' by default.
+             */
+            template <typename C, typename H = NoMemo, typename S = Truncation,
+                     typename A = Cascade, typename O = NullObserver,
+                     typename R = NoSurrogate, typename N = NoNiching> class Trivial {
+
+                public:
+
+                    /**
+                     * Constructor. The seed is drawn from 'std::random_device'.
+                     * @param pSize Pool Size.
+                     */
+                    Trivial(unsigned int pSize) : Trivial(pSize, Random::entropy()) {}
+
+                    /**
+                     * Constructor.
+                     * @param pSize Pool Size.
+                     * @param seed Random seed.
+                     */
+                    Trivial(unsigned int pSize, std::uint64_t seed) : _seed(seed), _count(pSize),
+                        _elite(1), _generation(0), _scheduled(false), _evaluations(0),
+                        _best(0.0), _stagnation(0), _offset(0.0), _checkpointed(true),
+                        _interval(0), _threads(0), _evaluationTime(nullptr), _mutationTime(nullptr) {
+                        _pool = new C*[pSize];
+                        _spare = new C*[pSize];
+                        _swap = new C*[pSize];
+                        _score = new double[pSize];
+                        _swapScore = new double[pSize];
+                        _fitness = new double[pSize];
+                        _order = new unsigned int[pSize];
+                        _operator = new unsigned int[pSize];
+                        _parentScore = new double[pSize];
+                        _bred = new bool[pSize];
+                        _dirty = new bool[pSize];
+                        _fresh = new bool[pSize];
+                        _screened = new bool[pSize];
+                        _fused = new bool[pSize];
+                        _changes = new Changes[pSize];
+                        _lineage = new C*[pSize];
+                        _lineageScore = new double[pSize];
+                        _hash = new std::size_t[pSize];
+                    }
+
+                    /**
+                     * Destructor.
+                     */
+                    ~Trivial() {
+                        delete []_pool;
+                        delete []_spare;
+                        delete []_swap;
+                        delete []_score;
+                        delete []_swapScore;
+                        delete []_fitness;
+                        delete []_order;
+                        delete []_operator;
+                        delete []_parentScore;
+                        delete []_bred;
+                        delete []_evaluationTime;
+                        delete []_mutationTime;
+                        delete []_dirty;
+                        delete []_fresh;
+                        delete []_screened;
+                        delete []_fused;
+                        delete []_changes;
+                        delete []_lineage;
+                        delete []_lineageScore;
+                        delete []_hash;
+                    }
+
+                    /**
+                     * @return Memo table.
+                     */
+                    H& memo() { return _memo; }
+
+                    /**
+                     * @return Selection policy.
+                     */
+                    S& selection() { return _selection; }
+
+                    /**
+                     * @return Operator scheduler.
+                     */
+                    A& scheduler() { return _scheduler; }
+
+                    /**
+                     * @return Observer.
+                     */
+                    O& observer() { return _observer; }
+
+                    /**
+                     * @return Surrogate.
+                     */
+                    R& surrogate() { return _surrogate; }
+
+                    /**
+                     * @return Niching policy.
+                     */
+                    N& niching() { return _niching; }
+
+                    /**
+                     * @return Random seed.
+                     */
+                    std::uint64_t seed() const { return _seed; }
+
+                    /**
+                     * Training.
+                     * @param <E> Creation and evaluation environment type. It must define
+                     *      the following methods:
+                     *      - void reserve(C**&, unsigned int)
+                     *        or void reserve(C**&, unsigned int, Random&)
+                     *      - void release(C**, unsigned int)
+                     *      - double evaluate(const C*)
+                     *        or double evaluate(const C*, Random&)
+                     *      - C* clone(const C*)
+                     *      and optionally:
+                     *      - void evaluate(const C* const*, unsigned int, double*)
+                     *        Batch evaluation, preferred when defined. Batches are
+                     *        split in one chunk per thread.
+                     *      - double evaluateDelta(const C* offspring, const C* parent,
+                     *            double parentScore, const Changes&)
+                     *        Evaluation out of the first parent, preferred for
+                     *        offspring whose mutator reported its changes.
+                     * @param <... M> Set of operators/mutators types. A mutator must define
+                     *      the following methods:
+                     *      - double threshold()
+                     *      - void mutate(C** parents, unsigned int count, C* offspring)
+                     *        or void mutate(C**, unsigned int, C*, Random&)
+                     *        or void mutate(C**, unsigned int, C*, Random&, Changes&)
+                     *        The latter records the genes that differ from the
+                     *        first parent, for delta evaluation.
+                     *      and optionally:
+                     *      - unsigned int arity()
+                     *        Number of parents it expects (2 by default, at most
+                     *        GA_MAX_ARITY). Parents are drawn by the selection policy.
+                     * @param env Environment.
+                     * @param maxGen Maximum number of generations.
+                     * @param minErr Minimal accepable error.
+                     * @param eliteSize Percentage of the pool to be taken for creating the next pool.
+                     * @param store A store for results.
+                     * @param size Size of the storage and maximum number of exit candidate.
+                     * @param mutators Set of operators/mutators for new pool creation.
+                     * @return The number of candidates stored in the specified buffer.
+                     * Training also stops on the additional criteria (see 'criteria')
+                     * or when the callback (see 'callback') asks to.
+                     */
+                    template <typename E, typename... M> int train(E* env,
+                            unsigned int maxGen, double minErr, double eliteSize,
+                            C** store, unsigned int size,
+                            M... mutators) {
+                        start(env, eliteSize);
+                        _best = 0.0;
+                        _stagnation = 0;
+                        _offset = 0.0;
+                        return run(env, maxGen, minErr, store, size, false, Pipeline<>(), mutators...);
+                    }
+
+                    /**
+                     * Training, running a pipeline of stages on each offspring
+                     * as soon as it is bred (see 'reproduce'). E.g. with
+                     * 'Pipeline<Evaluation>', offspring are evaluated in the
+                     * breeding loop.
+                     * @param env Environment.
+                     * @param pipeline Stages.
+                     * @see 'train' above for the other parameters.
+                     */
+                    template <typename E, typename... P, typename... M> int train(E* env,
+                            const Pipeline<P...>& pipeline,
+                            unsigned int maxGen, double minErr, double eliteSize,
+                            C** store, unsigned int size,
+                            M... mutators) {
+                        start(env, eliteSize);
+                        _best = 0.0;
+                        _stagnation = 0;
+                        _offset = 0.0;
+                        return run(env, maxGen, minErr, store, size, false, pipeline, mutators...);
+                    }
+
+                    /**
+                     * Resume a training from a checkpoint (see 'checkpoint'). For a
+                     * given checkpoint, results are identical to the ones of the
+                     * interrupted training, provided the same environment and
+                     * mutators are used and the mutators fully overwrite offspring.
+                     * The pool size must match the checkpoint one.
+                     * This does not hold with a surrogate or a niching policy:
+                     * which candidates have a predicted score is saved, but
+                     * neither the surrogate archive nor the niching state (e.g.
+                     * the novelty archive) are. The surrogate starts learning
+                     * over, and the fitness is recomputed from scratch at the
+                     * next generation, so that the resumed training diverges.
+                     * @param <W> Genome serializer. See 'checkpoint'.
+                     * @param env Environment.
+                     * @param in Checkpoint stream, opened in binary mode.
+                     * @param serializer Genome serializer.
+                     * @param maxGen Maximum number of generations, including the
+                     * ones done before the checkpoint.
+                     * @param minErr Minimal accepable error.
+                     * @param store A store for results.
+                     * @param size Size of the storage and maximum number of exit candidate.
+                     * @param mutators Set of operators/mutators for new pool creation.
+                     * @return The number of candidates stored in the specified buffer,
+                     * -1 if the checkpoint can't be read.
+                     */
+                    template <typename E, typename W, typename... M> int resume(E* env,
+                            std::istream& in, W* serializer,
+                            unsigned int maxGen, double minErr,
+                            C** store, unsigned int size,
+                            M... mutators) {
+                        if(!load(env, in, serializer)) {
+                            return -1;
+                        }
+                        return run(env, maxGen, minErr, store, size, true, Pipeline<>(), mutators...);
+                    }
+
+                    /**
+                     * Write checkpoints periodically during 'train' and 'resume'.
+                     * A checkpoint is first written in "<path>.tmp", then renamed,
+                     * so that the previous one stays valid until the new one is
+                     * complete. Failures do not stop the training: see
+                     * 'checkpointed'.
+                     * @param <W> Genome serializer. It must define the following methods:
+                     *     - void write(std::ostream&, const C*)
+                     *     - void read(std::istream&, C*)
+                     *       The candidate is provided by the environment 'reserve'.
+                     * @param path Checkpoint file.
+                     * @param interval Number of generations between checkpoints. 0
+                     * disables them.
+                     * @param serializer Genome serializer. Must outlive the trainings.
+                     */
+                    template <typename W> void checkpoint(const std::string& path, unsigned int interval,
+                            W* serializer) {
+                        _interval = interval;
+                        _checkpoint = [this, path, serializer]() {
+                            std::string temporary = path + ".tmp";
+                            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+                            bool written = save(out, serializer);
+                            out.close();
+                            if(!written || out.fail() || 0 != std::rename(temporary.c_str(), path.c_str())) {
+                                std::remove(temporary.c_str());
+                                return false;
+                            }
+                            return true;
+                        };
+                    }
+
+                    /**
+                     * @return 'false' if the last checkpoint could not be written
+                     * or renamed, the previous one being then the valid one.
+                     */
+                    bool checkpointed() const { return _checkpointed; }
+
+                    /**
+                     * Save the training state. Valid within the callback of 'train'
+                     * or 'resume' only.
+                     * @param out Output stream, opened in binary mode.
+                     * @param serializer Genome serializer. See 'checkpoint'.
+                     * @return 'false' on write failure.
+                     */
+                    template <typename W> bool save(std::ostream& out, W* serializer) const {
+                        Binary::write(out, "HLGA", 4);
+                        std::uint32_t version = GA_CHECKPOINT_VERSION;
+                        Binary::write(out, &version);
+                        Binary::write(out, &_count);
+                        Binary::write(out, &_elite);
+                        Binary::write(out, &_seed);
+                        Binary::write(out, &_generation);
+                        Binary::write(out, &_evaluations);
+                        Binary::write(out, &_best);
+                        Binary::write(out, &_stagnation);
+                        double elapsed = seconds();
+                        Binary::write(out, &elapsed);
+                        Binary::write(out, _score, _count);
+                        Binary::write(out, _screened, _count);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            serializer->write(out, static_cast<const C*>(_pool[i]));
+                        }
+                        _scheduler.write(out);
+                        _memo.write(out, serializer);
+                        out.flush();
+                        return out.good();
+                    }
+
+                    /**
+                     * @return Additional stop and restart criteria, used by 'train'.
+                     */
+                    Criteria& criteria() { return _criteria; }
+
+                    /**
+                     * Set the per-generation callback, called by 'train' after
+                     * each evaluation with the training 'Progress'. Returning
+                     * 'false' stops the training, the current elite being stored
+                     * as usual.
+                     * @param callback Callback. An empty one disables it.
+                     */
+                    void callback(const std::function<bool(const Progress<C>&)>& callback) {
+                        _callback = callback;
+                    }
+
+                    /**
+                     * @return Number of evaluations since 'start' (memo hits are free).
+                     */
+                    unsigned long long evaluations() const { return _evaluations; }
+
+                    /**
+                     * Cheap diversity estimate: distance from the best score to the
+                     * mean one. Valid after 'evaluate'. The pool is ranked by the
+                     * niching policy, so the best score is searched for.
+                     * @return Score spread.
+                     */
+                    double spread() const {
+                        double sum = 0.0;
+                        double best = _score[0];
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            sum += _score[i];
+                            best = _score[i] < best ? _score[i] : best;
+                        }
+                        return sum / _count - best;
+                    }
+
+                    /**
+                     * Replace the last candidates of the pool with new ones, to be
+                     * evaluated with the next generation.
+                     * @param env Environment.
+                     * @param fraction Fraction of the pool to replace, capped to the
+                     * non-elite part.
+                     */
+                    template <typename E> void restart(E* env, double fraction) {
+                        unsigned int count = _count * fraction;
+                        count = count < _count - _elite ? count : _count - _elite;
+                        C** renewed = _pool + _count - count;
+                        env->release(renewed, count);
+                        Random random(_seed, _generation, 2, Random::INITIALIZATION);
+                        Concept::reserve(env, renewed, count, random, 0);
+                        for(unsigned int i = _count - count; i < _count; ++i) {
+                            _dirty[i] = true;
+                            _fused[i] = false;
+                            _bred[i] = false;
+                        }
+                    }
+
+                    /**
+                     * Stepping interface. 'train' is made of these steps, which
+                     * lets composite engines drive and observe the pool between
+                     * generations:
+                     *     start(env, eliteSize);
+                     *     while(... && evaluate(env) > minErr) {
+                     *         reproduce(mutators...);
+                     *     }
+                     *     finish(env, store, size);
+                     */
+
+                    /**
+                     * Fill the pool. We assume that the pool is empty.
+                     * @param env Environment.
+                     * @param eliteSize Percentage of the pool to be taken for creating the next pool.
+                     */
+                    template <typename E> void start(E* env, double eliteSize) {
+                        _elite = _count * eliteSize;
+                        _elite = _elite < 1 ? 1 : (_elite > _count ? _count : _elite);
+                        _generation = 0;
+                        _evaluations = 0;
+                        Random random(_seed, 0, 0, Random::INITIALIZATION);
+                        Concept::reserve(env, _pool, _count, random, 0);
+                        Random spareRandom(_seed, 0, 1, Random::INITIALIZATION);
+                        Concept::reserve(env, _spare, _count - _elite, spareRandom, 0);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _dirty[i] = true;
+                            _fresh[i] = false;
+                            _screened[i] = false;
+                            _fused[i] = false;
+                            _bred[i] = false;
+                        }
+                        _scheduled = false;
+                        if(O::enabled) {
+                            prepareTelemetry();
+                        }
+                    }
+
+                    /**
+                     * Evaluate the pool against the environment.
+                     * @param env Environment.
+                     * @return Minimal error. At return time, the elite is at the
+                     * beginning of the pool, sorted using candidates scores (or
+                     * fitness, with niching), and the selection policy is ready.
+                     */
+                    template <typename E> double evaluate(E* env) {
+                        unsigned long long evaluations = _evaluations;
+                        // Evaluate what has changed ...
+                        measure(env, Concept::Batch<E, C>());
+
+                        // ... compute the fitness of the pool ...
+                        double* fitness = _score;
+                        if(N::enabled) {
+                            _niching.adjust(env, _pool, _score, _fitness, _count);
+                            fitness = _fitness;
+                        }
+
+                        // ... remember new scores, credit mutators ...
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_fresh[i]) {
+                                _memo.store(env, _pool[i], _hash[i], _score[i]);
+                                _surrogate.learn(env, _pool[i], _score[i]);
+                                _fresh[i] = false;
+                                ++_evaluations;
+                            }
+                            _fused[i] = false;
+                            if(_bred[i]) {
+                                _scheduler.reward(_operator[i], fitness[i] < _parentScore[i]);
+                                _bred[i] = false;
+                            }
+                        }
+                        if(_scheduled) {
+                            _scheduler.update();
+                        }
+
+                        // ... and rank.
+                        std::uint64_t begin = O::enabled ? Parallel::now() : 0;
+                        _selection.rank(fitness, _order, _count, _elite);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _swap[i] = _pool[_order[i]];
+                            _swapScore[i] = _score[_order[i]];
+                        }
+                        std::swap(_pool, _swap);
+                        std::swap(_score, _swapScore);
+                        if(N::enabled) {
+                            for(unsigned int i = 0; i < _count; ++i) {
+                                _swapScore[i] = _fitness[_order[i]];
+                            }
+                            std::swap(_fitness, _swapScore);
+                        }
+                        if(R::enabled) {
+                            // Fresh flags are all clear: use them as scratch.
+                            for(unsigned int i = 0; i < _count; ++i) {
+                                _fresh[i] = _screened[_order[i]];
+                            }
+                            std::swap(_fresh, _screened);
+                            std::fill(_fresh, _fresh + _count, false);
+                        }
+                        _selection.prepare(N::enabled ? _fitness : _score, _count, _elite);
+
+                        if(O::enabled) {
+                            report(Parallel::now() - begin, _evaluations - evaluations);
+                        }
+                        if(N::enabled) {
+                            // The best fitness is not the best score.
+                            return *std::min_element(_score, _score + _count);
+                        }
+                        return _score[0];
+                    }
+
+                    /**
+                     * Replace candidates from the elite size to the pool size by
+                     * offspring and move to the next generation.
+                     * @param mutators Set of operators/mutators for new pool creation.
+                     */
+                    template <typename... M> void reproduce(M... mutators) {
+                        breed(static_cast<void*>(nullptr), Pipeline<>(), mutators...);
+                    }
+
+                    /**
+                     * Same as above, running a pipeline of stages on each
+                     * offspring as soon as it is bred, in the same parallel
+                     * loop. Offspring evaluated by the pipeline are not
+                     * evaluated again by 'evaluate', nor screened by the
+                     * surrogate; for a deterministic environment, their
+                     * scores are the ones 'evaluate' would have computed.
+                     * @param env Environment, handed to the stages.
+                     * @param pipeline Stages.
+                     * @param mutators Set of operators/mutators for new pool creation.
+                     */
+                    template <typename E, typename... P, typename... M> void reproduce(E* env,
+                            const Pipeline<P...>& pipeline, M... mutators) {
+                        breed(env, pipeline, mutators...);
+                    }
+
+                    /**
+                     * Take the ownership of foreign candidates. They replace the
+                     * last candidates of the pool and will be evaluated with the
+                     * next generation.
+                     * @param env Environment.
+                     * @param candidates Candidates.
+                     * @param count Number of candidates. At most pool size minus
+                     * elite size.
+                     */
+                    template <typename E> void immigrate(E* env, C** candidates, unsigned int count) {
+                        for(unsigned int i = 0; i < count; ++i) {
+                            unsigned int position = _count - 1 - i;
+                            env->release(_pool + position, 1);
+                            _pool[position] = candidates[i];
+                            _dirty[position] = true;
+                            _fused[position] = false;
+                            _bred[position] = false;
+                        }
+                    }
+
+                    /**
+                     * Store the elite and release the pool.
+                     * @param env Environment.
+                     * @param store A store for results.
+                     * @param size Size of the storage and maximum number of exit candidate.
+                     * @param scores If not null, receives the scores of the stored candidates.
+                     * @return The number of candidates stored in the specified buffer.
+                     */
+                    template <typename E> int finish(E* env, C** store, unsigned int size,
+                            double* scores = nullptr) {
+                        unsigned int number = _elite < size ? _elite : size;
+                        for(unsigned int i = 0; i < number; ++i) {
+                            store[i] = env->clone(_pool[i]);
+                            if(nullptr != scores) {
+                                scores[i] = _score[i];
+                            }
+                        }
+
+                        // Clean-up the pool.
+                        env->release(_pool, _count);
+                        env->release(_spare, _count - _elite);
+                        _memo.clear(env);
+                        _surrogate.clear(env);
+                        _niching.clear(env);
+
+                        return number;
+                    }
+
+                    /**
+                     * @param index Position in the pool.
+                     * @return Candidate. After 'evaluate', the elite comes first.
+                     */
+                    const C* candidate(unsigned int index) const { return _pool[index]; }
+
+                    /**
+                     * @param index Position in the pool.
+                     * @return Candidate score, as of the last 'evaluate'.
+                     */
+                    double score(unsigned int index) const { return _score[index]; }
+
+                    /**
+                     * @return Pool size.
+                     */
+                    unsigned int size() const { return _count; }
+
+                    /**
+                     * @return Elite size.
+                     */
+                    unsigned int elite() const { return _elite; }
+
+                    /**
+                     * @return Current generation.
+                     */
+                    unsigned int generation() const { return _generation; }
+
+                    /**
+                     * View of an offspring being bred, handed to pipeline stages.
+                     */
+                    class Offspring {
+                        public:
+                            /**
+                             * @return The genome.
+                             */
+                            C* genome() { return _genome; }
+
+                            /**
+                             * @return Random stream of the offspring, as left by
+                             * its mutator.
+                             */
+                            Random& random() { return _random; }
+
+                            /**
+                             * @return Genes the offspring doesn't share with its
+                             * first parent.
+                             */
+                            Changes& changes() { return _engine->_changes[_position]; }
+
+                            /**
+                             * @return First parent.
+                             */
+                            const C* parent() const { return _engine->_lineage[_position]; }
+
+                            /**
+                             * @return Score of the first parent.
+                             */
+                            double parentScore() const { return _engine->_lineageScore[_position]; }
+
+                            /**
+                             * @return Whether the offspring is evaluated.
+                             */
+                            bool evaluated() const { return _engine->_fused[_position]; }
+
+                            /**
+                             * Evaluate the offspring, unless done already: memo
+                             * lookup, then evaluation out of the first parent if
+                             * changes are known, full evaluation otherwise.
+                             * @param env Environment.
+                             * @return Score.
+                             */
+                            template <typename E> double evaluate(E* env) {
+                                Trivial& engine = *_engine;
+                                double& score = engine._swapScore[_position];
+                                if(engine._fused[_position]) {
+                                    return score;
+                                }
+                                std::uint64_t begin = O::enabled ? Parallel::now() : 0;
+                                bool known = engine._memo.lookup(_genome, engine._hash[_position], score);
+                                if(!known) {
+                                    // The stream 'evaluate' would use at the next generation.
+                                    Random random(engine._seed, engine._generation + 1, _position,
+                                            Random::EVALUATION);
+                                    Changes& changes = engine._changes[_position];
+                                    score = changes.known()
+                                        ? Concept::delta(env, _genome, parent(), parentScore(), changes, random, 0)
+                                        : Concept::evaluate(env, _genome, random, 0);
+                                }
+                                engine._fresh[_position] = !known;
+                                engine._fused[_position] = true;
+                                if(O::enabled) {
+                                    engine._evaluationTime[Parallel::index()] += Parallel::now() - begin;
+                                }
+                                return score;
+                            }
+
+                        private:
+                            Offspring(Trivial* engine, unsigned int position, C* genome, Random& random) :
+                                _engine(engine), _position(position), _genome(genome), _random(random) {}
+
+                            friend class Trivial;
+
+                        private:
+                            Trivial*     _engine;
+                            unsigned int _position;
+                            C*           _genome;
+                            Random&      _random;
+                    };
+
+                private:
+                    /**
+                     * Training loop, from a started or a loaded pool.
+                     * @param resumed 'true' if the pool was loaded from a
+                     * checkpoint, i.e. is already evaluated.
+                     * @param pipeline Stages run on each offspring.
+                     */
+                    template <typename E, typename L, typename... M> int run(E* env,
+                            unsigned int maxGen, double minErr,
+                            C** store, unsigned int size, bool resumed,
+                            const L& pipeline, M... mutators) {
+                        _begin = std::chrono::steady_clock::now();
+                        // Loop on generations.
+                        while(_generation < maxGen) {
+                            if(resumed) {
+                                resumed = false;
+                            } else {
+                                double best = evaluate(env);
+                                if(best <= minErr) {
+                                    break;
+                                }
+                                if(0 == _generation || best < _best - _criteria.tolerance) {
+                                    _best = best;
+                                    _stagnation = 0;
+                                } else {
+                                    ++_stagnation;
+                                }
+                                if(_checkpoint && _interval > 0 && 0 == _generation % _interval) {
+                                    _checkpointed = _checkpoint();
+                                }
+                                if(_callback) {
+                                    Progress<C> progress = { _generation, _evaluations, seconds(),
+                                        _pool, _score, _elite };
+                                    if(!_callback(progress)) {
+                                        break;
+                                    }
+                                }
+                            }
+                            if((_criteria.window > 0 && _stagnation >= _criteria.window)
+                                    || (_criteria.evaluations > 0 && _evaluations >= _criteria.evaluations)
+                                    || (_criteria.seconds > 0.0 && seconds() >= _criteria.seconds)) {
+                                break;
+                            }
+                            bool collapsed = _criteria.restart > 0.0 && spread() <= _criteria.collapse;
+                            breed(env, pipeline, mutators...);
+                            if(collapsed) {
+                                restart(env, _criteria.restart);
+                            }
+                        }
+                        return finish(env, store, size);
+                    }
+
+                    /**
+                     * @return Training time, in seconds, including the time before
+                     * the last checkpoint when resumed.
+                     */
+                    double seconds() const {
+                        return _offset + std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - _begin).count();
+                    }
+
+                    /**
+                     * Load the training state saved by 'save'. The pool is
+                     * allocated and filled.
+                     * @return 'false' if the checkpoint is invalid.
+                     */
+                    template <typename E, typename W> bool load(E* env, std::istream& in, W* serializer) {
+                        char magic[4];
+                        std::uint32_t version;
+                        unsigned int count;
+                        unsigned int elite;
+                        std::uint64_t seed;
+                        unsigned int generation;
+                        unsigned long long evaluations;
+                        double best;
+                        unsigned int stagnation;
+                        double offset;
+                        // Nothing is used before the whole header is known to be read.
+                        if(!Binary::read(in, magic, 4) || 0 != std::char_traits<char>::compare(magic, "HLGA", 4)
+                                || !Binary::read(in, &version) || GA_CHECKPOINT_VERSION != version
+                                || !Binary::read(in, &count) || count != _count
+                                || !Binary::read(in, &elite) || elite < 1 || elite > _count
+                                || !Binary::read(in, &seed) || !Binary::read(in, &generation)
+                                || !Binary::read(in, &evaluations) || !Binary::read(in, &best)
+                                || !Binary::read(in, &stagnation) || !Binary::read(in, &offset)
+                                || !Binary::read(in, _swapScore, _count) || !Binary::read(in, _fresh, _count)) {
+                            return false;
+                        }
+                        _elite = elite;
+                        _seed = seed;
+                        _generation = generation;
+                        _evaluations = evaluations;
+                        _best = best;
+                        _stagnation = stagnation;
+                        _offset = offset;
+                        std::copy(_swapScore, _swapScore + _count, _score);
+                        std::copy(_fresh, _fresh + _count, _screened);
+
+                        Random random(_seed, 0, 0, Random::INITIALIZATION);
+                        Concept::reserve(env, _pool, _count, random, 0);
+                        Random spareRandom(_seed, 0, 1, Random::INITIALIZATION);
+                        Concept::reserve(env, _spare, _count - _elite, spareRandom, 0);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            serializer->read(in, _pool[i]);
+                            _dirty[i] = false;
+                            _fresh[i] = false;
+                            _screened[i] = R::enabled && _screened[i];
+                            _fused[i] = false;
+                            _bred[i] = false;
+                        }
+                        if(O::enabled) {
+                            prepareTelemetry();
+                        }
+                        _scheduled = in.good() && _scheduler.read(in);
+                        if(!_scheduled || !_memo.read(in, env, serializer)) {
+                            env->release(_pool, _count);
+                            env->release(_spare, _count - _elite);
+                            _memo.clear(env);
+                            return false;
+                        }
+                        if(N::enabled) {
+                            // The niching state is not saved: start over from the scores.
+                            std::copy(_score, _score + _count, _fitness);
+                        }
+                        _selection.prepare(N::enabled ? _fitness : _score, _count, _elite);
+                        return true;
+                    }
+
+                    /**
+                     * Allocate and clear the per-thread time counters.
+                     */
+                    void prepareTelemetry() {
+                        unsigned int threads = Parallel::count();
+                        if(threads > _threads) {
+                            delete []_evaluationTime;
+                            delete []_mutationTime;
+                            _evaluationTime = new std::uint64_t[threads];
+                            _mutationTime = new std::uint64_t[threads];
+                            _threads = threads;
+                        }
+                        for(unsigned int i = 0; i < _threads; ++i) {
+                            _evaluationTime[i] = 0;
+                            _mutationTime[i] = 0;
+                        }
+                    }
+
+                    /**
+                     * Hand the telemetry of the evaluated generation to the
+                     * observer and clear the time counters.
+                     * @param selection Time spent ranking.
+                     * @param evaluations Number of evaluations.
+                     */
+                    void report(std::uint64_t selection, unsigned int evaluations) {
+                        double sum = 0.0;
+                        double squares = 0.0;
+                        double worst = _score[0];
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            sum += _score[i];
+                            squares += _score[i] * _score[i];
+                            worst = _score[i] > worst ? _score[i] : worst;
+                        }
+                        double mean = sum / _count;
+                        double variance = squares / _count - mean * mean;
+                        Telemetry telemetry = { _generation, _score[0], mean, worst,
+                            std::sqrt(variance > 0.0 ? variance : 0.0), evaluations,
+                            _threads, _evaluationTime, _mutationTime, selection };
+                        _observer.observe(telemetry);
+                        for(unsigned int i = 0; i < _threads; ++i) {
+                            _evaluationTime[i] = 0;
+                            _mutationTime[i] = 0;
+                        }
+                    }
+
+                    /**
+                     * Look modified candidates up in the memo table and flag the
+                     * ones to evaluate as fresh, after screening if any.
+                     */
+                    void lookup() {
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_dirty[i] || _screened[i]) {
+                                _fresh[i] = !_memo.lookup(_pool[i], _hash[i], _score[i]);
+                                _dirty[i] = false;
+                                _screened[i] = false;
+                            }
+                        }
+                        if(R::enabled && _surrogate.ready()) {
+                            screen();
+                        }
+                    }
+
+                    /**
+                     * Keep the offspring with the best predictions fresh. The
+                     * others get their prediction as score. Ranking buffers are
+                     * used as scratch.
+                     */
+                    void screen() {
+                        unsigned int count = 0;
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_fresh[i] && _bred[i] && !_fused[i]) {
+                                _order[count++] = i;
+                            }
+                        }
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < count; ++i) {
+                            _swapScore[_order[i]] = _surrogate.predict(_pool[_order[i]]);
+                        }
+                        unsigned int kept = static_cast<unsigned int>(std::ceil(count * _surrogate.ratio()));
+                        kept = kept < 1 ? 1 : kept;
+                        if(kept >= count) {
+                            return;
+                        }
+                        const double* predicted = _swapScore;
+                        std::nth_element(_order, _order + kept, _order + count,
+                                [predicted](unsigned int a, unsigned int b) {
+                                    return predicted[a] < predicted[b] || (predicted[a] == predicted[b] && a < b);
+                                });
+                        for(unsigned int i = kept; i < count; ++i) {
+                            unsigned int index = _order[i];
+                            _score[index] = predicted[index];
+                            _fresh[index] = false;
+                            _screened[index] = true;
+                        }
+                    }
+
+                    /**
+                     * Breed offspring in the spare buffer, run the pipeline on
+                     * them, and let them replace the non-elite candidates.
+                     */
+                    template <typename E, typename L, typename... M> void breed(E* env, const L& pipeline,
+                            M... mutators) {
+                        unsigned int offspringCount = _count - _elite;
+                        if(!_scheduled) {
+                            _scheduler.start(sizeof...(M));
+                            _scheduled = true;
+                        }
+                        // Let's breed offspring in the spare buffer ...
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < offspringCount; ++i) {
+                            // Randomly choose a mutators.
+                            std::uint64_t begin = O::enabled ? Parallel::now() : 0;
+                            Random random(_seed, _generation, _elite + i);
+                            unsigned int index = _scheduler.choose(random, mutators...);
+                            Changes& changes = _changes[_elite + i];
+                            _parentScore[_elite + i] = Breeding::apply(index, _pool,
+                                    N::enabled ? _fitness : _score, _selection,
+                                    _spare[i], random, &changes, mutators...);
+                            _operator[_elite + i] = index;
+                            _lineage[_elite + i] = _pool[changes.parent];
+                            _lineageScore[_elite + i] = _score[changes.parent];
+                            if(R::enabled && _screened[changes.parent]) {
+                                // A predicted score is no ground for a delta.
+                                changes.forget();
+                            }
+                            if(O::enabled) {
+                                _mutationTime[Parallel::index()] += Parallel::now() - begin;
+                            }
+                            Offspring offspring(this, _elite + i, _spare[i], random);
+                            pipeline.run(env, offspring);
+                        }
+                        // ... and let them replace the non-elite candidates.
+                        for(unsigned int i = 0; i < offspringCount; ++i) {
+                            unsigned int position = _elite + i;
+                            C* candidate = _pool[position];
+                            _pool[position] = _spare[i];
+                            _spare[i] = candidate;
+                            _dirty[position] = !_fused[position];
+                            _bred[position] = true;
+                            if(_fused[position]) {
+                                _score[position] = _swapScore[position];
+                                _screened[position] = false;
+                            }
+                        }
+                        ++_generation;
+                    }
+
+                    /**
+                     * Evaluate modified candidates one by one.
+                     */
+                    template <typename E> void measure(E* env, std::false_type) {
+                        lookup();
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_fresh[i] && !_fused[i]) {
+                                std::uint64_t begin = O::enabled ? Parallel::now() : 0;
+                                Random random(_seed, _generation, i, Random::EVALUATION);
+                                if(_bred[i] && _changes[i].known()) {
+                                    _score[i] = Concept::delta(env, _pool[i], _lineage[i], _lineageScore[i],
+                                            _changes[i], random, 0);
+                                } else {
+                                    _score[i] = Concept::evaluate(env, _pool[i], random, 0);
+                                }
+                                if(O::enabled) {
+                                    _evaluationTime[Parallel::index()] += Parallel::now() - begin;
+                                }
+                            }
+                        }
+                    }
+
+                    /**
+                     * Evaluate modified candidates as a batch, but for the ones
+                     * the environment evaluates out of their parent. Ranking
+                     * buffers are used as scratch.
+                     */
+                    template <typename E> void measure(E* env, std::true_type) {
+                        lookup();
+                        bool delta = Concept::Delta<E, C>::value;
+                        if(delta) {
+                            #pragma omp parallel for
+                            for(unsigned int i = 0; i < _count; ++i) {
+                                if(_fresh[i] && !_fused[i] && _bred[i] && _changes[i].known()) {
+                                    std::uint64_t begin = O::enabled ? Parallel::now() : 0;
+                                    Random random(_seed, _generation, i, Random::EVALUATION);
+                                    _score[i] = Concept::delta(env, _pool[i], _lineage[i], _lineageScore[i],
+                                            _changes[i], random, 0);
+                                    if(O::enabled) {
+                                        _evaluationTime[Parallel::index()] += Parallel::now() - begin;
+                                    }
+                                }
+                            }
+                        }
+                        unsigned int count = 0;
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_fresh[i] && !_fused[i] && !(delta && _bred[i] && _changes[i].known())) {
+                                _swap[count] = _pool[i];
+                                _order[count++] = i;
+                            }
+                        }
+                        Concept::batch(env, _swap, count, _swapScore, O::enabled ? _evaluationTime : nullptr);
+                        for(unsigned int i = 0; i < count; ++i) {
+                            _score[_order[i]] = _swapScore[i];
+                        }
+                    }
+
+                private:
+
+                    /**
+                     * Random seed.
+                     */
+                    std::uint64_t _seed;
+
+                    /**
+                     * Candidate pool.
+                     */
+                    C** _pool;
 
-namespace Headless {
-    namespace Logic {
-        /**
-         * Here are proposed some implementations of General Algorithms.
-         * Currently available GAs are:
-         *  - Trivial.
-         */
-        namespace GA {
+                    /**
+                     * Offspring buffer.
+                     */
+                    C** _spare;
+
+                    /**
+                     * Ranking buffer.
+                     */
+                    C** _swap;
+
+                    /**
+                     * Pool score.
+                     */
+                    double *_score;
+
+                    /**
+                     * Ranking buffer.
+                     */
+                    double *_swapScore;
+
+                    /**
+                     * Fitness, out of the niching policy.
+                     */
+                    double *_fitness;
+
+                    /**
+                     * Ranking order.
+                     */
+                    unsigned int *_order;
+
+                    /**
+                     * Mutator of each offspring.
+                     */
+                    unsigned int *_operator;
+
+                    /**
+                     * Best parent score of each offspring.
+                     */
+                    double *_parentScore;
+
+                    /**
+                     * Offspring not yet credited to their mutator.
+                     */
+                    bool *_bred;
+
+                    /**
+                     * Modified since last evaluation.
+                     */
+                    bool *_dirty;
+
+                    /**
+                     * Evaluated and not yet remembered.
+                     */
+                    bool *_fresh;
+
+                    /**
+                     * Candidate hashes, for the memo table.
+                     */
+                    std::size_t *_hash;
+
+                    /**
+                     * Pool count.
+                     */
+                    unsigned int _count;
+
+                    /**
+                     * Elite count.
+                     */
+                    unsigned int _elite;
+
+                    /**
+                     * Current generation.
+                     */
+                    unsigned int _generation;
+
+                    /**
+                     * Memo table.
+                     */
+                    H _memo;
+
+                    /**
+                     * Surrogate.
+                     */
+                    R _surrogate;
+
+                    /**
+                     * Niching policy.
+                     */
+                    N _niching;
+
+                    /**
+                     * Flags offspring evaluated by a pipeline, since 'reproduce'.
+                     */
+                    bool* _fused;
+
+                    /**
+                     * Flags candidates whose score is a prediction.
+                     */
+                    bool* _screened;
+
+                    /**
+                     * Changes of offspring against their first parent.
+                     */
+                    Changes* _changes;
+
+                    /**
+                     * First parent of offspring. Parents outlive the evaluation
+                     * of their offspring (elite or spare buffer).
+                     */
+                    C** _lineage;
+
+                    /**
+                     * Score of the first parent of offspring.
+                     */
+                    double* _lineageScore;
+
+                    /**
+                     * Selection policy.
+                     */
+                    S _selection;
+
+                    /**
+                     * Operator scheduler.
+                     */
+                    A _scheduler;
+
+                    /**
+                     * Scheduler started for the current training.
+                     */
+                    bool _scheduled;
+
+                    /**
+                     * Number of evaluations since start.
+                     */
+                    unsigned long long _evaluations;
+
+                    /**
+                     * Additional criteria.
+                     */
+                    Criteria _criteria;
+
+                    /**
+                     * Per-generation callback.
+                     */
+                    std::function<bool(const Progress<C>&)> _callback;
+
+                    /**
+                     * Best score, for stagnation detection.
+                     */
+                    double _best;
+
+                    /**
+                     * Number of generations without improvement.
+                     */
+                    unsigned int _stagnation;
+
+                    /**
+                     * Start of the current training loop.
+                     */
+                    std::chrono::steady_clock::time_point _begin;
+
+                    /**
+                     * Training time before the current loop, when resumed.
+                     */
+                    double _offset;
+
+                    /**
+                     * Checkpoint writer.
+                     */
+                    std::function<bool()> _checkpoint;
+
+                    /**
+                     * Whether the last checkpoint was written.
+                     */
+                    bool _checkpointed;
+
+                    /**
+                     * Generations between checkpoints.
+                     */
+                    unsigned int _interval;
+
+                    /**
+                     * Observer.
+                     */
+                    O _observer;
+
+                    /**
+                     * Number of per-thread time counters.
+                     */
+                    unsigned int _threads;
+
+                    /**
+                     * Time spent in evaluation, per thread.
+                     */
+                    std::uint64_t* _evaluationTime;
+
+                    /**
+                     * Time spent breeding, per thread.
+                     */
+                    std::uint64_t* _mutationTime;
+            };
 
             /**
-             * Trivial GA.
-             * 1. Generate first pool.
-             * 2. Evaluate pool against a testing environment.
-             * 3. Save the elite.
-             * 4. Create new pool from elite using set of operators.
-             * 5. Back to step 2 until error is superior to specified
-             *    or until generation number is inferior to specified.
+             * Multi-objective GA (NSGA-II).
+             * Each generation breeds as many offspring as there are parents;
+             * parents and offspring are then sorted into non-dominated fronts
+             * and the best fronts make the next parents. The front that
+             * doesn't fit entirely is cut by crowding distance, which favours
+             * isolated solutions and thus spreads the Pareto front.
              *
-             * To this purpose, we need the following concepts :
+             * Parents are drawn by binary tournament on (front, crowding
+             * distance). All objectives are minimized; a NaN objective (e.g.
+             * a failed simulation) ranks as +infinity.
+             *
+             * Dominance is computed for all pairs at once, in parallel, and
+             * kept in a matrix: memory is quadratic in the pool size. Crowding
+             * distances are computed in parallel over the fronts. For a given
+             * seed, results are identical whatever the number of threads.
+             *
+             * Concepts are the ones of 'Trivial', except for evaluation.
              * @param <C> Candidates to be evaluated and modified.
+             * @param <K> Number of objectives.
              */
-            template <typename C> class Trivial {
+            template <typename C, unsigned int K> class Pareto {
 
                 public:
 
+                    /**
+                     * Constructor. The seed is drawn from 'std::random_device'.
+                     * @param pSize Pool Size, i.e. number of parents.
+                     */
+                    Pareto(unsigned int pSize) : Pareto(pSize, Random::entropy()) {}
+
                     /**
                      * Constructor.
-                     * @param pSize Pool Size.
+                     * @param pSize Pool Size, i.e. number of parents.
+                     * @param seed Random seed.
                      */
-                    Trivial(unsigned int pSize) : _count(pSize) {
-                        _pool = new C*[pSize];
-                        _score = new double[pSize];
+                    Pareto(unsigned int pSize, std::uint64_t seed) : _seed(seed), _count(pSize),
+                        _front(0), _generation(0) {
+                        unsigned int total = 2 * pSize;
+                        _pool = new C*[total];
+                        _swap = new C*[total];
+                        _objective = new double[total * K];
+                        _swapObjective = new double[total * K];
+                        _rank = new double[total];
+                        _swapRank = new double[total];
+                        _distance = new double[total];
+                        _swapDistance = new double[total];
+                        _order = new unsigned int[total];
+                        _dominators = new unsigned int[total];
+                        _fronts = new unsigned int[total + 1];
+                        _dominance = new bool[total * total];
                     }
 
                     /**
                      * Destructor.
                      */
-                    ~Trivial() {
+                    ~Pareto() {
                         delete []_pool;
-                        delete []_score;
+                        delete []_swap;
+                        delete []_objective;
+                        delete []_swapObjective;
+                        delete []_rank;
+                        delete []_swapRank;
+                        delete []_distance;
+                        delete []_swapDistance;
+                        delete []_order;
+                        delete []_dominators;
+                        delete []_fronts;
+                        delete []_dominance;
                     }
 
+                    /**
+                     * @return Random seed.
+                     */
+                    std::uint64_t seed() const { return _seed; }
+
+                    /**
+                     * @return Number of generations of the last training.
+                     */
+                    unsigned int generation() const { return _generation; }
+
                     /**
                      * Training.
                      * @param <E> Creation and evaluation environment type. It must define
                      *      the following methods:
                      *      - void reserve(C**&, unsigned int)
+                     *        or void reserve(C**&, unsigned int, Random&)
                      *      - void release(C**, unsigned int)
-                     *      - double evaluate (const C*)
+                     *      - void evaluate(const C*, double* objectives)
+                     *        or void evaluate(const C*, double*, Random&)
+                     *        Write the 'K' objectives of a candidate.
                      *      - C* clone(const C*)
-                     * @param <... M> Set of operators/mutators types. A mutator must define
-                     *      the following methods:
-                     *      - double threshold()
-                     *      - void mutate(C**, unsigned int, C*);
+                     * @param <... M> Set of operators/mutators types. See 'Trivial::train'.
                      * @param env Environment.
-                     * @param maxGen Maximum number of generations.
-                     * @param minErr Minimal accepable error.
-                     * @param eliteSize Percentage of the pool to be taken for creating the next pool.
-                     * @param store A store for results.
+                     * @param maxGen Number of generations.
+                     * @param store A store for results, the Pareto front.
                      * @param size Size of the storage and maximum number of exit candidate.
                      * @param mutators Set of operators/mutators for new pool creation.
                      * @return The number of candidates stored in the specified buffer.
+                     * Their objectives are given by 'objectives'.
                      */
                     template <typename E, typename... M> int train(E* env,
-                            unsigned int maxGen, double minErr, double eliteSize,
-                            C** store, unsigned int size,
+                            unsigned int maxGen, C** store, unsigned int size,
                             M... mutators) {
-                        unsigned int eliteCount = _count * eliteSize;
-                        // We assume that the pool is empty and needs to be filled.
-                        env->reserve(_pool, _count);
+                        // Parents, then offspring buffers.
+                        Random random(_seed, 0, 0, Random::INITIALIZATION);
+                        Concept::reserve(env, _pool, 2 * _count, random, 0);
+                        measure(env, 0, 0, _count);
+                        sort(_count);
 
-                        // Loop on generations.
-                        for(unsigned int g = 0;
-                                (g < maxGen) && (evaluate(env) > minErr);
-                                ++g) {
-                            // At this point, the pool is full and sorted.
-                            // Let's recycle candidates from eliteCount to _count - 1.
+                        for(_generation = 0; _generation < maxGen; ++_generation) {
+                            Crowding selection(_rank, _distance, _count);
                             #pragma omp parallel for
-                            for(unsigned int i = eliteCount; i < _count; ++i) {
-                                // Randomly choose a mutators.
-                                mutate(i, eliteCount, mutators...);
+                            for(unsigned int i = 0; i < _count; ++i) {
+                                Random random(_seed, _generation, i);
+                                Breeding::mutate(_pool, _rank, selection, _pool[_count + i],
+                                        random, mutators...);
                             }
+                            measure(env, _generation + 1, _count, 2 * _count);
+                            sort(2 * _count);
                         }
 
-                        unsigned int number = eliteCount < size ? eliteCount : size;
+                        unsigned int number = _front < size ? _front : size;
                         for(unsigned int i = 0; i < number; ++i) {
                             store[i] = env->clone(_pool[i]);
                         }
-
-                        // Clean-up the pool.
-                        env->release(_pool, _count);
-
+                        env->release(_pool, 2 * _count);
                         return number;
                     }
 
+                    /**
+                     * @param index Result index.
+                     * @return Objectives of a result of the last training.
+                     */
+                    const double* objectives(unsigned int index) const { return _objective + index * K; }
+
                 private:
+                    Pareto(const Pareto&);
+                    Pareto& operator=(const Pareto&);
+
                     /**
-                     * make a new offspring out of the available mutators.
+                     * Binary tournament on front, then on crowding distance.
                      */
-                    template <typename M, typename... O> void mutate(unsigned int pos, unsigned int count,
-                            M mutator, O... others) {
-                        std::random_device rd;
-                        std::mt19937 mt(rd());
-                        std::uniform_real_distribution<double> dist(0.0, 1.0);
-                        double rnd = dist(mt);
-                        if(rnd < mutator->threshold()) {
-                            mutator->mutate(_pool, count, _pool[pos]);
-                        } else {
-                            mutate(pos, count, others...);
-                        }
-                    }
+                    class Crowding {
+                        public:
+                            Crowding(const double* rank, const double* distance, unsigned int count) :
+                                _rank(rank), _distance(distance), _count(count) {}
 
-                    template <typename M> void mutate(unsigned int pos, unsigned int count, M mutator) {
-                        mutator->mutate(_pool, count, _pool[pos]);
-                    }
+                            unsigned int select(Random& random) const {
+                                unsigned int a = random.below(_count);
+                                unsigned int b = random.below(_count);
+                                if(_rank[b] < _rank[a] || (_rank[b] == _rank[a] && _distance[b] > _distance[a])) {
+                                    return b;
+                                }
+                                return a;
+                            }
+
+                        private:
+                            const double* _rank;
+                            const double* _distance;
+                            unsigned int  _count;
+                    };
 
                     /**
-                     * Evaluate the pool against the environment.
-                     * @param <E> Environment type.
-                     * @param env Environment.
-                     * @return Minimal error. At return time, the pool is sorted
-                     * using candidates scores.
+                     * Evaluate candidates from 'first' to 'last' (excluded).
                      */
-                    template <typename E> double evaluate(E* env) {
-                        // Evaluate ...
+                    template <typename E> void measure(E* env, unsigned int generation,
+                            unsigned int first, unsigned int last) {
                         #pragma omp parallel for
-                        for(unsigned int i = 0; i < _count; ++i) {
-                            _score[i] = env->evaluate(_pool[i]);
+                        for(unsigned int i = first; i < last; ++i) {
+                            Random random(_seed, generation, i, Random::EVALUATION);
+                            Concept::evaluate(env, _pool[i], _objective + i * K, random, 0);
                         }
+                    }
 
-                        // ... and sort.
-                        qsort(0, _count - 1);
+                    /**
+                     * @return The objective value to sort by: NaN is +infinity,
+                     * so that dominance stays transitive.
+                     */
+                    static double order(double value) {
+                        return value != value ? std::numeric_limits<double>::infinity() : value;
+                    }
 
-                        return _score[0];
+                    /**
+                     * @return 1 if 'a' dominates 'b', -1 if 'b' dominates 'a', 0 otherwise.
+                     */
+                    int compare(unsigned int a, unsigned int b) const {
+                        const double* left = _objective + a * K;
+                        const double* right = _objective + b * K;
+                        bool better = false;
+                        bool worse = false;
+                        for(unsigned int k = 0; k < K; ++k) {
+                            double l = order(left[k]);
+                            double r = order(right[k]);
+                            better = better || l < r;
+                            worse = worse || l > r;
+                        }
+                        return better == worse ? 0 : (better ? 1 : -1);
                     }
 
                     /**
-                     * Simple quick sort for our specific case.
-                     * @param lo Lower bound.
-                     * @param hi Higher bound.
+                     * Sort the 'total' first candidates into fronts and keep the
+                     * best 'count' ones first, with their front and crowding
+                     * distance. Rejected ones follow, as offspring buffers.
                      */
-                    void qsort(unsigned int lo, unsigned int hi) {
-                        if(lo < hi) {
-                            // We don't make fat partitionning as we are manipulating
-                            // fine-grained over-distributed scores. We should not
-                            // have arrays of identical scores.
-                            unsigned int pivot = partition(lo, hi);
-                            if((pivot - lo) < (hi - (pivot + 1))) {
-                                qsort(lo, pivot);
-                                qsort(pivot + 1, hi);
-                            } else {
-                                qsort(pivot + 1, hi);
-                                qsort(lo, pivot);
+                    void sort(unsigned int total) {
+                        // Dominance matrix and domination counts.
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < total; ++i) {
+                            bool* row = _dominance + i * total;
+                            unsigned int dominators = 0;
+                            for(unsigned int j = 0; j < total; ++j) {
+                                int relation = compare(i, j);
+                                row[j] = relation > 0;
+                                dominators += relation < 0 ? 1 : 0;
                             }
+                            _dominators[i] = dominators;
+                        }
 
+                        // Peel fronts off until enough candidates are kept.
+                        unsigned int size = 0;
+                        for(unsigned int i = 0; i < total; ++i) {
+                            if(0 == _dominators[i]) {
+                                _order[size++] = i;
+                            }
+                        }
+                        unsigned int fronts = 0;
+                        _fronts[0] = 0;
+                        _fronts[++fronts] = size;
+                        while(size < _count) {
+                            unsigned int previous = size;
+                            for(unsigned int f = _fronts[fronts - 1]; f < _fronts[fronts]; ++f) {
+                                const bool* row = _dominance + _order[f] * total;
+                                for(unsigned int j = 0; j < total; ++j) {
+                                    if(row[j] && 0 == --_dominators[j]) {
+                                        _order[size++] = j;
+                                    }
+                                }
+                            }
+                            if(previous == size) {
+                                // No progress: dominance is cyclic. Should not
+                                // happen; the remaining candidates make a last front.
+                                for(unsigned int j = 0; j < total; ++j) {
+                                    if(0 != _dominators[j]) {
+                                        _dominators[j] = 0;
+                                        _order[size++] = j;
+                                    }
+                                }
+                            }
+                            _fronts[++fronts] = size;
+                        }
+
+                        #pragma omp parallel for schedule(dynamic)
+                        for(unsigned int f = 0; f < fronts; ++f) {
+                            crowd(_fronts[f], _fronts[f + 1], f);
+                        }
+
+                        // Cut the last front by decreasing crowding distance.
+                        const double* distance = _distance;
+                        std::sort(_order + _fronts[fronts - 1], _order + _fronts[fronts],
+                                [distance](unsigned int a, unsigned int b) {
+                                    return distance[a] > distance[b] || (distance[a] == distance[b] && a < b);
+                                });
+                        _front = _fronts[1] < _count ? _fronts[1] : _count;
+
+                        // Rejected candidates, in index order.
+                        for(unsigned int i = 0; i < total; ++i) {
+                            _dominators[i] = 0;
+                        }
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _dominators[_order[i]] = 1;
+                        }
+                        for(unsigned int i = 0, j = _count; i < total; ++i) {
+                            if(0 == _dominators[i]) {
+                                _order[j++] = i;
+                            }
                         }
-                    }
 
-                    unsigned int partition(unsigned int lo, unsigned int hi) {
-                        double pivot = _score[lo];
-                        unsigned int i = lo - 1;
-                        unsigned int j = hi + 1;
+                        for(unsigned int i = 0; i < total; ++i) {
+                            unsigned int index = _order[i];
+                            _swap[i] = _pool[index];
+                            _swapRank[i] = _rank[index];
+                            _swapDistance[i] = _distance[index];
+                            std::copy(_objective + index * K, _objective + (index + 1) * K,
+                                    _swapObjective + i * K);
+                        }
+                        std::copy(_pool + total, _pool + 2 * _count, _swap + total);
+                        std::swap(_pool, _swap);
+                        std::swap(_rank, _swapRank);
+                        std::swap(_distance, _swapDistance);
+                        std::swap(_objective, _swapObjective);
+                    }
 
-                        for(;;) {
-                            do {
-                                ++i;
-                            } while(_score[i] < pivot);
-                            do {
-                                --j;
-                            } while(_score[j] > pivot);
-                            if(i >= j) {
-                                return j;
+                    /**
+                     * Crowding distance of the candidates of a front, i.e. the
+                     * normalized size of the box their neighbours span. Boundary
+                     * candidates get an infinite distance.
+                     * @param begin First position of the front in the order.
+                     * @param end Position after its last one.
+                     * @param rank Front index.
+                     */
+                    void crowd(unsigned int begin, unsigned int end, unsigned int rank) {
+                        unsigned int* first = _order + begin;
+                        unsigned int* last = _order + end;
+                        for(unsigned int* i = first; i < last; ++i) {
+                            _rank[*i] = rank;
+                            _distance[*i] = 0.0;
+                        }
+                        for(unsigned int k = 0; k < K; ++k) {
+                            const double* objective = _objective + k;
+                            std::sort(first, last, [objective](unsigned int a, unsigned int b) {
+                                double left = order(objective[a * K]);
+                                double right = order(objective[b * K]);
+                                return left < right || (left == right && a < b);
+                            });
+                            double range = order(objective[*(last - 1) * K]) - order(objective[*first * K]);
+                            _distance[*first] = std::numeric_limits<double>::infinity();
+                            _distance[*(last - 1)] = std::numeric_limits<double>::infinity();
+                            // An infinite range leaves inner candidates unranked on 'k'.
+                            for(unsigned int* i = first + 1; range > 0.0 && range < std::numeric_limits<double>::infinity()
+                                    && i + 1 < last; ++i) {
+                                _distance[*i] += (objective[*(i + 1) * K] - objective[*(i - 1) * K]) / range;
                             }
-                            double score = _score[i];
-                            C* candidate = _pool[i];
-                            _score[i] = _score[j];
-                            _pool[i] = _pool[j];
-                            _score[j] = score;
-                            _pool[j] = candidate;
                         }
-                        return 0; // Should never happen.
                     }
 
                 private:
+                    /**
+                     * Random seed.
+                     */
+                    std::uint64_t _seed;
 
                     /**
-                     * Candidate pool.
+                     * Parents, sorted by front, then offspring.
                      */
                     C** _pool;
 
                     /**
-                     * Pool score.
+                     * Sorting buffer.
                      */
-                    double *_score;
+                    C** _swap;
 
                     /**
-                     * Pool count.
+                     * Objectives, 'K' per candidate.
+                     */
+                    double* _objective;
+
+                    /**
+                     * Objectives sorting buffer.
+                     */
+                    double* _swapObjective;
+
+                    /**
+                     * Front index of each candidate.
+                     */
+                    double* _rank;
+
+                    /**
+                     * Front index sorting buffer.
+                     */
+                    double* _swapRank;
+
+                    /**
+                     * Crowding distance of each candidate.
+                     */
+                    double* _distance;
+
+                    /**
+                     * Crowding distance sorting buffer.
+                     */
+                    double* _swapDistance;
+
+                    /**
+                     * Sorting order.
+                     */
+                    unsigned int* _order;
+
+                    /**
+                     * Number of dominating candidates, during sorting.
+                     */
+                    unsigned int* _dominators;
+
+                    /**
+                     * Front boundaries in the sorting order.
+                     */
+                    unsigned int* _fronts;
+
+                    /**
+                     * Dominance matrix: row 'i' tells which candidates 'i' dominates.
+                     */
+                    bool* _dominance;
+
+                    /**
+                     * Pool count, i.e. number of parents.
                      */
                     unsigned int _count;
+
+                    /**
+                     * Size of the first front among parents.
+                     */
+                    unsigned int _front;
+
+                    /**
+                     * Generation number.
+                     */
+                    unsigned int _generation;
             };
 
         } // Namespace 'GA'
@@ -0,0 +1,348 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM_BITS
+#define HEADLESS_LOGIC_GENETIC_ALGORITHM_BITS
+
+#include "geneticalgorithm.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace GA {
+
+            /**
+             * Fixed-length bit string genome, packed in 64-bit words.
+             * Bit 'i' is bit 'i % 64' of word 'i / 64'; bits past 'N' are
+             * always clear. Operators below work a word at a time (loops
+             * over words are simple enough to be vectorized by the compiler).
+             * @param <N> Number of bits.
+             */
+            template <unsigned int N> class Bits {
+                static_assert(N > 0, "A bit string needs at least one bit.");
+
+                public:
+                    static const unsigned int size = N;
+                    static const unsigned int words = (N + 63) / 64;
+
+                    Bits() {
+                        for(unsigned int i = 0; i < words; ++i) {
+                            _word[i] = 0;
+                        }
+                    }
+
+                    bool get(unsigned int bit) const { return (_word[bit / 64] >> (bit % 64)) & 1; }
+
+                    void set(unsigned int bit, bool value) {
+                        std::uint64_t mask = static_cast<std::uint64_t>(1) << (bit % 64);
+                        _word[bit / 64] = value ? _word[bit / 64] | mask : _word[bit / 64] & ~mask;
+                    }
+
+                    void flip(unsigned int bit) { _word[bit / 64] ^= static_cast<std::uint64_t>(1) << (bit % 64); }
+
+                    std::uint64_t* data() { return _word; }
+                    const std::uint64_t* data() const { return _word; }
+
+                    /**
+                     * Draw all bits uniformly.
+                     */
+                    void randomize(Random& random) {
+                        for(unsigned int i = 0; i < words; ++i) {
+                            _word[i] = draw(random);
+                        }
+                        _word[words - 1] &= last();
+                    }
+
+                    /**
+                     * @return Number of set bits.
+                     */
+                    unsigned int count() const {
+                        unsigned int result = 0;
+                        for(unsigned int i = 0; i < words; ++i) {
+                            result += population(_word[i]);
+                        }
+                        return result;
+                    }
+
+                    /**
+                     * @return Hamming distance.
+                     */
+                    unsigned int distance(const Bits& other) const {
+                        unsigned int result = 0;
+                        for(unsigned int i = 0; i < words; ++i) {
+                            result += population(_word[i] ^ other._word[i]);
+                        }
+                        return result;
+                    }
+
+                    bool operator==(const Bits& other) const {
+                        for(unsigned int i = 0; i < words; ++i) {
+                            if(_word[i] != other._word[i]) {
+                                return false;
+                            }
+                        }
+                        return true;
+                    }
+
+                    /**
+                     * @return 64 random bits.
+                     */
+                    static std::uint64_t draw(Random& random) {
+                        std::uint64_t high = random();
+                        return (high << 32) | random();
+                    }
+
+                    /**
+                     * @return Mask of the bits of the last word that are in use.
+                     */
+                    static std::uint64_t last() {
+                        return 0 == N % 64 ? ~static_cast<std::uint64_t>(0)
+                            : (static_cast<std::uint64_t>(1) << (N % 64)) - 1;
+                    }
+
+                    /**
+                     * @return Number of set bits of a word.
+                     */
+                    static unsigned int population(std::uint64_t word) {
+#if defined(__GNUC__)
+                        return __builtin_popcountll(word);
+#else
+                        word = word - ((word >> 1) & 0x5555555555555555ULL);
+                        word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+                        word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+                        return (word * 0x0101010101010101ULL) >> 56;
+#endif
+                    }
+
+                    /**
+                     * Record the bits that differ from a parent, until changes
+                     * are too many to be known.
+                     */
+                    void changes(const Bits& parent, Changes& changes) const {
+                        for(unsigned int i = 0; i < words && changes.known(); ++i) {
+                            std::uint64_t diff = _word[i] ^ parent._word[i];
+                            for(; 0 != diff && changes.known(); diff &= diff - 1) {
+                                changes.add(i * 64 + lowest(diff));
+                            }
+                        }
+                    }
+
+                    /**
+                     * Copy the bits of a range from another genome.
+                     * @param source Genome to copy from.
+                     * @param from First bit.
+                     * @param to Bit after the last one.
+                     */
+                    void copy(const Bits& source, unsigned int from, unsigned int to) {
+                        for(unsigned int i = from / 64; i < words && i * 64 < to; ++i) {
+                            std::uint64_t mask = ~static_cast<std::uint64_t>(0);
+                            if(i == from / 64) {
+                                mask &= ~static_cast<std::uint64_t>(0) << (from % 64);
+                            }
+                            if(i == to / 64) {
+                                mask &= (static_cast<std::uint64_t>(1) << (to % 64)) - 1;
+                            }
+                            _word[i] = (_word[i] & ~mask) | (source._word[i] & mask);
+                        }
+                    }
+
+                private:
+                    /**
+                     * @return Index of the lowest set bit of a non-null word.
+                     */
+                    static unsigned int lowest(std::uint64_t word) {
+#if defined(__GNUC__)
+                        return __builtin_ctzll(word);
+#else
+                        return population((word & (0 - word)) - 1);
+#endif
+                    }
+
+                private:
+                    std::uint64_t _word[words];
+            };
+
+            /**
+             * Hashing concept of 'Bits', for 'Memo'.
+             */
+            template <unsigned int N> class BitsHash {
+                public:
+                    std::size_t hash(const Bits<N>* genome) const {
+                        // FNV-1a on words.
+                        std::uint64_t hash = 14695981039346656037ULL;
+                        for(unsigned int i = 0; i < Bits<N>::words; ++i) {
+                            hash = (hash ^ genome->data()[i]) * 1099511628211ULL;
+                        }
+                        return static_cast<std::size_t>(hash);
+                    }
+
+                    bool equals(const Bits<N>* a, const Bits<N>* b) const {
+                        return *a == *b;
+                    }
+            };
+
+            /**
+             * Hamming distance concept of 'Bits', for 'Nearest'.
+             */
+            template <unsigned int N> class BitsDistance {
+                public:
+                    double distance(const Bits<N>* a, const Bits<N>* b) const {
+                        return a->distance(*b);
+                    }
+            };
+
+            /**
+             * Uniform crossover: each bit comes from either parent, a word of
+             * random mask at a time.
+             */
+            template <unsigned int N> class UniformCrossover {
+                public:
+                    UniformCrossover(double threshold = 0.8) : _threshold(threshold) {}
+
+                    double threshold() { return _threshold; }
+
+                    unsigned int arity() { return 2; }
+
+                    void mutate(Bits<N>** parents, unsigned int, Bits<N>* offspring,
+                            Random& random, Changes& changes) {
+                        const std::uint64_t* first = parents[0]->data();
+                        const std::uint64_t* second = parents[1]->data();
+                        std::uint64_t* data = offspring->data();
+                        for(unsigned int i = 0; i < Bits<N>::words; ++i) {
+                            std::uint64_t mask = Bits<N>::draw(random);
+                            data[i] = (first[i] & mask) | (second[i] & ~mask);
+                        }
+                        offspring->changes(*parents[0], changes);
+                    }
+
+                private:
+                    double _threshold;
+            };
+
+            /**
+             * One-point crossover: bits before a random cut come from the
+             * first parent, the others from the second one. The cut is
+             * strictly inside the string, hence at least two bits.
+             */
+            template <unsigned int N> class OnePointCrossover {
+                static_assert(N > 1, "A one-point crossover needs at least two bits.");
+
+                public:
+                    OnePointCrossover(double threshold = 0.8) : _threshold(threshold) {}
+
+                    double threshold() { return _threshold; }
+
+                    unsigned int arity() { return 2; }
+
+                    void mutate(Bits<N>** parents, unsigned int, Bits<N>* offspring,
+                            Random& random, Changes& changes) {
+                        unsigned int cut = 1 + random.below(N - 1);
+                        *offspring = *parents[0];
+                        offspring->copy(*parents[1], cut, N);
+                        offspring->changes(*parents[0], changes);
+                    }
+
+                private:
+                    double _threshold;
+            };
+
+            /**
+             * Two-point crossover: bits between two random cuts come from the
+             * second parent, the others from the first one.
+             */
+            template <unsigned int N> class TwoPointCrossover {
+                public:
+                    TwoPointCrossover(double threshold = 0.8) : _threshold(threshold) {}
+
+                    double threshold() { return _threshold; }
+
+                    unsigned int arity() { return 2; }
+
+                    void mutate(Bits<N>** parents, unsigned int, Bits<N>* offspring,
+                            Random& random, Changes& changes) {
+                        unsigned int from = random.below(N);
+                        unsigned int to = random.below(N);
+                        if(from > to) {
+                            std::swap(from, to);
+                        }
+                        *offspring = *parents[0];
+                        offspring->copy(*parents[1], from, to + 1);
+                        offspring->changes(*parents[0], changes);
+                    }
+
+                private:
+                    double _threshold;
+            };
+
+            /**
+             * Bit-flip mutation: each bit flips with the given rate. Flipped
+             * bits are reached by geometric skips, so the cost is the number
+             * of flips rather than the number of bits. At least one bit flips.
+             * Rates of 0 or less (or NaN) only flip that one bit, rates of 1 or
+             * more flip them all.
+             */
+            template <unsigned int N> class BitFlip {
+                public:
+                    /**
+                     * @param rate Flip probability of a bit, 1/N by default.
+                     * @param threshold Threshold of the mutator.
+                     */
+                    BitFlip(double rate = 1.0 / N, double threshold = 1.0) : _threshold(threshold),
+                        _skip(!(rate > 0.0) ? -std::numeric_limits<double>::infinity()
+                                : (rate < 1.0 ? 1.0 / std::log(1.0 - rate) : 0.0)) {}
+
+                    double threshold() { return _threshold; }
+
+                    unsigned int arity() { return 1; }
+
+                    void mutate(Bits<N>** parents, unsigned int, Bits<N>* offspring,
+                            Random& random, Changes& changes) {
+                        *offspring = *parents[0];
+                        unsigned int flipped = 0;
+                        for(unsigned int bit = skip(random); bit < N; bit += 1 + skip(random)) {
+                            offspring->flip(bit);
+                            changes.add(bit);
+                            ++flipped;
+                        }
+                        if(0 == flipped) {
+                            unsigned int bit = random.below(N);
+                            offspring->flip(bit);
+                            changes.add(bit);
+                        }
+                    }
+
+                private:
+                    /**
+                     * @return Number of bits to skip before the next flip.
+                     */
+                    unsigned int skip(Random& random) const {
+                        // NaN (0 * inf) and +inf mean no more flips.
+                        double length = std::floor(std::log(1.0 - random.uniform()) * _skip);
+                        if(!(length < N)) {
+                            return N;
+                        }
+                        return length > 0.0 ? static_cast<unsigned int>(length) : 0;
+                    }
+
+                private:
+                    double _threshold;
+                    /** 1 / log(1 - rate), 0 if rate >= 1, -inf if rate <= 0. */
+                    double _skip;
+            };
+
+        } // Namespace 'GA'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
@@ -0,0 +1,378 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM_CONTIGUOUS
+#define HEADLESS_LOGIC_GENETIC_ALGORITHM_CONTIGUOUS
+
+#include <utility>
+#include "geneticalgorithm.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace GA {
+            namespace Concept {
+                template <typename E, typename C>
+                    auto initialize(E* env, C* pool, unsigned int count,
+                            Random& random, int) -> decltype(env->initialize(pool, count, random), void()) {
+                        env->initialize(pool, count, random);
+                    }
+
+                template <typename E, typename C>
+                    void initialize(E* env, C* pool, unsigned int count, Random&, long) {
+                        env->initialize(pool, count);
+                    }
+            } // Namespace 'Concept'
+
+            /**
+             * No column layout: 'Contiguous' candidates are only stored by value.
+             *
+             * A column layout keeps a structure-of-arrays copy of the pool
+             * (e.g. one array per gene), so that the environment evaluates
+             * candidates a gene at a time across the pool. It must define:
+             * - static const bool enabled
+             *   'false' compiles the columns out.
+             * - void reserve(unsigned int count)
+             *   Allocate columns for 'count' candidates. Called once.
+             * - void store(unsigned int index, const C& candidate)
+             *   Scatter a candidate into the columns. Called concurrently,
+             *   on distinct indices.
+             */
+            class NoColumns {
+                public:
+                    static const bool enabled = false;
+                    void reserve(unsigned int) {}
+                    template <typename C> void store(unsigned int, const C&) {}
+            };
+
+            /**
+             * Contiguous GA.
+             * Same algorithm as 'Trivial', for compact fixed-size genomes stored
+             * by value. The pool lives in one array and offspring are written
+             * in a second one (elite copied first, in rank order), then both
+             * are swapped. All buffers are allocated at construction: a
+             * generation does no heap allocation, and evaluation streams
+             * through memory.
+             *
+             * Elite scores are carried over, so only offspring are evaluated.
+             * For a given seed, results are identical whatever the number of
+             * threads.
+             *
+             * With a column layout, operators still work on candidates by
+             * value, but each candidate is also scattered into the columns as
+             * soon as it is bred, and the environment evaluates columns.
+             *
+             * To this purpose, we need the following concepts :
+             * @param <C> Candidates. Default constructible and copy assignable,
+             *     ideally trivially copyable.
+             * @param <S> Selection policy.
+             * @param <L> Column layout (see 'NoColumns').
+             */
+            template <typename C, typename S = Truncation, typename L = NoColumns> class Contiguous {
+
+                public:
+
+                    /**
+                     * Constructor. The seed is drawn from 'std::random_device'.
+                     * @param pSize Pool Size.
+                     */
+                    Contiguous(unsigned int pSize) : Contiguous(pSize, Random::entropy()) {}
+
+                    /**
+                     * Constructor.
+                     * @param pSize Pool Size.
+                     * @param seed Random seed.
+                     */
+                    Contiguous(unsigned int pSize, std::uint64_t seed) : _seed(seed), _count(pSize),
+                        _elite(0) {
+                        _current = new C[pSize];
+                        _next = new C[pSize];
+                        _score = new double[pSize];
+                        _nextScore = new double[pSize];
+                        _rankScore = new double[pSize];
+                        _order = new unsigned int[pSize];
+                        _ranked = new C*[pSize];
+                        _layout.reserve(pSize);
+                    }
+
+                    /**
+                     * Destructor.
+                     */
+                    ~Contiguous() {
+                        delete []_current;
+                        delete []_next;
+                        delete []_score;
+                        delete []_nextScore;
+                        delete []_rankScore;
+                        delete []_order;
+                        delete []_ranked;
+                    }
+
+                    /**
+                     * @return Selection policy.
+                     */
+                    S& selection() { return _selection; }
+
+                    /**
+                     * @return Column layout.
+                     */
+                    L& layout() { return _layout; }
+
+                    /**
+                     * @return Random seed.
+                     */
+                    std::uint64_t seed() const { return _seed; }
+
+                    /**
+                     * Training.
+                     * @param <E> Creation and evaluation environment type. It must define
+                     *      the following methods:
+                     *      - void initialize(C*, unsigned int)
+                     *        or void initialize(C*, unsigned int, Random&)
+                     *      - double evaluate(const C*)
+                     *        or double evaluate(const C*, Random&)
+                     *      and optionally the batch evaluation (see 'Trivial::train').
+                     *      With a column layout, it must instead define
+                     *      - void evaluate(const L& columns, unsigned int first,
+                     *            unsigned int count, double* scores)
+                     *        scoring candidates 'first' to 'first + count'
+                     *        (excluded), the first one into 'scores[0]'.
+                     * @param <... M> Set of operators/mutators types. See 'Trivial::train'.
+                     * @param env Environment.
+                     * @param maxGen Maximum number of generations. With 0, the
+                     *     initial pool is only evaluated and ranked.
+                     * @param minErr Minimal accepable error.
+                     * @param eliteSize Percentage of the pool to be taken for creating the next pool.
+                     * @param mutators Set of operators/mutators for new pool creation.
+                     * @return The number of results, i.e. the elite size.
+                     */
+                    template <typename E, typename... M> unsigned int train(E* env,
+                            unsigned int maxGen, double minErr, double eliteSize,
+                            M... mutators) {
+                        _elite = _count * eliteSize;
+                        _elite = _elite < 1 ? 1 : (_elite > _count ? _count : _elite);
+                        Random random(_seed, 0, 0, Random::INITIALIZATION);
+                        Concept::initialize(env, _current, _count, random, 0);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _layout.store(i, _current[i]);
+                        }
+
+                        // Loop on generations. Without any, the initial pool
+                        // is still evaluated so that results have scores.
+                        unsigned int g = 0;
+                        unsigned int first = 0;
+                        bool ranked = 0 == maxGen;
+                        if(ranked) {
+                            evaluate(env, g, first);
+                        }
+                        while(g < maxGen) {
+                            ranked = evaluate(env, g, first) <= minErr;
+                            if(ranked) {
+                                break;
+                            }
+                            reproduce(g, mutators...);
+                            first = _elite;
+                            ++g;
+                        }
+
+                        // Make the elite come first, if not done yet.
+                        if(ranked) {
+                            promote();
+                        }
+                        return _elite;
+                    }
+
+                    /**
+                     * View on the results of the last training, sorted by score.
+                     * Valid until the next training.
+                     * @return The elite.
+                     */
+                    const C* results() const { return _current; }
+
+                    /**
+                     * @param index Result index.
+                     * @return Score of a result.
+                     */
+                    double score(unsigned int index) const { return _score[index]; }
+
+                    /**
+                     * Move the results of the last training out of the engine.
+                     * @param store A store for results.
+                     * @param size Size of the storage.
+                     * @return The number of candidates stored in the specified buffer.
+                     */
+                    unsigned int move(C* store, unsigned int size) {
+                        unsigned int number = _elite < size ? _elite : size;
+                        for(unsigned int i = 0; i < number; ++i) {
+                            store[i] = std::move(_current[i]);
+                        }
+                        return number;
+                    }
+
+                private:
+                    Contiguous(const Contiguous&);
+                    Contiguous& operator=(const Contiguous&);
+
+                    /**
+                     * Evaluate candidates from 'first' on and rank the pool.
+                     * @return Minimal error.
+                     */
+                    template <typename E> double evaluate(E* env, unsigned int generation,
+                            unsigned int first) {
+                        measure(env, generation, first, std::integral_constant<bool, L::enabled>(),
+                                Concept::Batch<E, C>());
+
+                        _selection.rank(_score, _order, _count, _elite);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _ranked[i] = _current + _order[i];
+                            _rankScore[i] = _score[_order[i]];
+                        }
+                        _selection.prepare(_rankScore, _count, _elite);
+                        return _rankScore[0];
+                    }
+
+                    /**
+                     * Evaluate columns.
+                     */
+                    template <typename E, typename B> void measure(E* env, unsigned int,
+                            unsigned int first, std::true_type, B) {
+                        env->evaluate(static_cast<const L&>(_layout), first, _count - first, _score + first);
+                    }
+
+                    /**
+                     * Evaluate candidates one by one.
+                     */
+                    template <typename E> void measure(E* env, unsigned int generation,
+                            unsigned int first, std::false_type, std::false_type) {
+                        #pragma omp parallel for
+                        for(unsigned int i = first; i < _count; ++i) {
+                            Random random(_seed, generation, i, Random::EVALUATION);
+                            _score[i] = Concept::evaluate(env, _current + i, random, 0);
+                        }
+                    }
+
+                    /**
+                     * Evaluate candidates as a batch. The ranking buffer is used
+                     * as scratch.
+                     */
+                    template <typename E> void measure(E* env, unsigned int,
+                            unsigned int first, std::false_type, std::true_type) {
+                        for(unsigned int i = first; i < _count; ++i) {
+                            _ranked[i] = _current + i;
+                        }
+                        Concept::batch(env, _ranked + first, _count - first, _score + first);
+                    }
+
+                    /**
+                     * Breed the next pool and swap it with the current one.
+                     */
+                    template <typename... M> void reproduce(unsigned int generation, M... mutators) {
+                        copyElite();
+                        #pragma omp parallel for
+                        for(unsigned int i = _elite; i < _count; ++i) {
+                            Random random(_seed, generation, i);
+                            Breeding::mutate(_ranked, _rankScore, _selection, _next + i, random, mutators...);
+                            _layout.store(i, _next[i]);
+                        }
+                        std::swap(_current, _next);
+                        std::swap(_score, _nextScore);
+                    }
+
+                    /**
+                     * Make the ranked elite the beginning of the current pool.
+                     */
+                    void promote() {
+                        copyElite();
+                        std::swap(_current, _next);
+                        std::swap(_score, _nextScore);
+                    }
+
+                    /**
+                     * Copy the ranked elite at the beginning of the next pool.
+                     */
+                    void copyElite() {
+                        for(unsigned int i = 0; i < _elite; ++i) {
+                            _next[i] = *_ranked[i];
+                            _layout.store(i, _next[i]);
+                            _nextScore[i] = _rankScore[i];
+                        }
+                    }
+
+                private:
+                    /**
+                     * Random seed.
+                     */
+                    std::uint64_t _seed;
+
+                    /**
+                     * Candidate pool.
+                     */
+                    C* _current;
+
+                    /**
+                     * Next pool.
+                     */
+                    C* _next;
+
+                    /**
+                     * Pool score.
+                     */
+                    double* _score;
+
+                    /**
+                     * Next pool score.
+                     */
+                    double* _nextScore;
+
+                    /**
+                     * Scores in rank order.
+                     */
+                    double* _rankScore;
+
+                    /**
+                     * Ranking order.
+                     */
+                    unsigned int* _order;
+
+                    /**
+                     * Candidates in rank order, i.e. the parents.
+                     */
+                    C** _ranked;
+
+                    /**
+                     * Pool count.
+                     */
+                    unsigned int _count;
+
+                    /**
+                     * Elite count.
+                     */
+                    unsigned int _elite;
+
+                    /**
+                     * Selection policy.
+                     */
+                    S _selection;
+
+                    /**
+                     * Column copy of the pool.
+                     */
+                    L _layout;
+            };
+
+        } // Namespace 'GA'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
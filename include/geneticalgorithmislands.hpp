@@ -0,0 +1,359 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM_ISLANDS
+#define HEADLESS_LOGIC_GENETIC_ALGORITHM_ISLANDS
+
+#include <atomic>
+#include "geneticalgorithm.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace GA {
+
+            /**
+             * Migration settings.
+             */
+            struct Migration {
+                /**
+                 * Who receives the migrants.
+                 */
+                enum Topology {
+                    /** Island 'i' receives from island 'i - 1'. */
+                    RING,
+                    /** Each island receives from a randomly chosen one. */
+                    RANDOM
+                };
+
+                Migration() : topology(RING), interval(10), count(2) {}
+
+                /** Migration topology. */
+                Topology     topology;
+                /** Generations between migrations. 0 disables migration. */
+                unsigned int interval;
+                /** Number of migrants (the best candidates of an island). */
+                unsigned int count;
+            };
+
+            /**
+             * Per-island statistics, as of the end of the last training.
+             */
+            struct IslandStatistics {
+                IslandStatistics() : generations(0), best(0.0), emigrants(0), immigrants(0) {}
+
+                /** Number of evaluated generations. */
+                unsigned int       generations;
+                /** Best score. */
+                double             best;
+                /** Number of candidates sent to other islands. */
+                unsigned long long emigrants;
+                /** Number of candidates received from other islands. */
+                unsigned long long immigrants;
+            };
+
+            /**
+             * Island-model GA.
+             * Several 'Trivial' pools evolve independently, each one on its own
+             * thread, and periodically send copies of their best candidates to
+             * another island, where they replace the worst ones.
+             *
+             * Exchange is lock-free and asynchronous: each island publishes its
+             * migrants in its own outbox with an atomic exchange, and receivers
+             * take the content of the outbox of their source, if any, the same
+             * way. Islands never wait for each other; as a consequence, results
+             * depend on thread scheduling as soon as migration is enabled.
+             *
+             * Training stops as soon as one island reaches the minimal error.
+             *
+             * Pools are processed by one thread each. Their own parallel loops
+             * are thus sequential unless nested parallelism is enabled
+             * (OMP_MAX_ACTIVE_LEVELS).
+             *
+             * Concepts are the ones of 'Trivial', except that the environment
+             * 'reserve', 'release' and 'clone' methods are called concurrently
+             * by islands and must be thread-safe.
+             * @param <C> Candidates to be evaluated and modified.
+             * @param <H> Memo table, one per island. 'NoMemo' or 'Memo'.
+             * @param <S> Selection policy.
+             * @param <A> Operator scheduler, one per island.
+             * @param <O> Observer, one per island. It is called by the island
+             *     thread.
+             * @param <R> Surrogate, one per island.
+             * @param <N> Niching policy, one per island.
+             */
+            template <typename C, typename H = NoMemo, typename S = Truncation,
+                     typename A = Cascade, typename O = NullObserver,
+                     typename R = NoSurrogate, typename N = NoNiching> class Islands {
+                public:
+                    typedef Trivial<C, H, S, A, O, R, N> Island;
+
+                public:
+                    /**
+                     * Constructor. The seed is drawn from 'std::random_device'.
+                     * @param count Number of islands.
+                     * @param pSize Pool size of each island.
+                     */
+                    Islands(unsigned int count, unsigned int pSize) : Islands(count, pSize, Random::entropy()) {}
+
+                    /**
+                     * Constructor.
+                     * @param count Number of islands.
+                     * @param pSize Pool size of each island.
+                     * @param seed Random seed. Each island gets its own seed out of it.
+                     */
+                    Islands(unsigned int count, unsigned int pSize, std::uint64_t seed) :
+                        _seed(seed), _count(count) {
+                        _islands = new Island*[count];
+                        _outbox = new std::atomic<C**>[count];
+                        _statistics = new IslandStatistics[count];
+                        for(unsigned int i = 0; i < count; ++i) {
+                            Random random(seed, 0, i, Random::MIGRATION);
+                            std::uint64_t high = random();
+                            _islands[i] = new Island(pSize, (high << 32) | random());
+                            _outbox[i].store(nullptr, std::memory_order_relaxed);
+                        }
+                    }
+
+                    /**
+                     * Destructor.
+                     */
+                    ~Islands() {
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            delete _islands[i];
+                        }
+                        delete []_islands;
+                        delete []_outbox;
+                        delete []_statistics;
+                    }
+
+                    /**
+                     * @return Migration settings.
+                     */
+                    Migration& migration() { return _migration; }
+
+                    /**
+                     * @param index Island index.
+                     * @return Island engine, e.g. to tune its memo table or
+                     * selection policy.
+                     */
+                    Island& island(unsigned int index) { return *_islands[index]; }
+
+                    /**
+                     * @param index Island index.
+                     * @return Island statistics.
+                     */
+                    const IslandStatistics& statistics(unsigned int index) const { return _statistics[index]; }
+
+                    /**
+                     * @return Number of islands.
+                     */
+                    unsigned int size() const { return _count; }
+
+                    /**
+                     * @return Random seed.
+                     */
+                    std::uint64_t seed() const { return _seed; }
+
+                    /**
+                     * Training. See 'Trivial::train'.
+                     * @param env Environment.
+                     * @param maxGen Maximum number of generations of each island.
+                     * @param minErr Minimal accepable error.
+                     * @param eliteSize Percentage of each pool to be taken for creating the next pool.
+                     * @param store A store for results, the best over all islands.
+                     * @param size Size of the storage and maximum number of exit candidate.
+                     * @param mutators Set of operators/mutators for new pool creation.
+                     * @return The number of candidates stored in the specified buffer.
+                     */
+                    template <typename E, typename... M> int train(E* env,
+                            unsigned int maxGen, double minErr, double eliteSize,
+                            C** store, unsigned int size,
+                            M... mutators) {
+                        C** found = new C*[_count * size];
+                        double* scores = new double[_count * size];
+                        unsigned int* number = new unsigned int[_count];
+                        _done.store(false, std::memory_order_relaxed);
+
+                        #pragma omp parallel for schedule(static, 1) num_threads(_count)
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            run(env, i, maxGen, minErr, eliteSize, mutators...);
+                            number[i] = _islands[i]->finish(env, found + i * size, size, scores + i * size);
+                        }
+
+                        // Drop migrants nobody took.
+                        unsigned int migrants = migrantCount(*_islands[0]);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            C** batch = _outbox[i].exchange(nullptr);
+                            if(nullptr != batch) {
+                                env->release(batch, migrants);
+                                delete []batch;
+                            }
+                        }
+
+                        // Keep the best of all islands.
+                        unsigned int total = 0;
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            for(unsigned int j = 0; j < number[i]; ++j, ++total) {
+                                found[total] = found[i * size + j];
+                                scores[total] = scores[i * size + j];
+                            }
+                        }
+                        unsigned int* order = new unsigned int[total];
+                        Truncation ranking;
+                        ranking.rank(scores, order, total, total);
+                        unsigned int result = total < size ? total : size;
+                        for(unsigned int i = 0; i < total; ++i) {
+                            if(i < result) {
+                                store[i] = found[order[i]];
+                            } else {
+                                env->release(found + order[i], 1);
+                            }
+                        }
+
+                        delete []order;
+                        delete []number;
+                        delete []scores;
+                        delete []found;
+                        return result;
+                    }
+
+                private:
+                    Islands(const Islands&);
+                    Islands& operator=(const Islands&);
+
+                    /**
+                     * @param island A started island. They all have the same sizes.
+                     * @return Number of migrants per exchange.
+                     */
+                    unsigned int migrantCount(const Island& island) const {
+                        unsigned int available = island.size() - island.elite();
+                        return _migration.count < available ? _migration.count : available;
+                    }
+
+                    /**
+                     * Evolve an island.
+                     */
+                    template <typename E, typename... M> void run(E* env, unsigned int index,
+                            unsigned int maxGen, double minErr, double eliteSize,
+                            M... mutators) {
+                        Island& island = *_islands[index];
+                        IslandStatistics& statistics = _statistics[index];
+                        statistics = IslandStatistics();
+                        island.start(env, eliteSize);
+                        unsigned int migrants = migrantCount(island);
+                        bool enabled = _count > 1 && migrants > 0 && _migration.interval > 0;
+                        // Islands started after another one succeeded (e.g. with
+                        // fewer threads than islands) still rank their pool once,
+                        // so that their results have scores.
+                        while(0 == statistics.generations
+                                || (island.generation() < maxGen && !_done.load(std::memory_order_relaxed))) {
+                            statistics.best = island.evaluate(env);
+                            statistics.generations = island.generation() + 1;
+                            if(statistics.best <= minErr) {
+                                _done.store(true, std::memory_order_relaxed);
+                                break;
+                            }
+                            bool migrate = enabled && 0 == statistics.generations % _migration.interval;
+                            if(migrate) {
+                                emigrate(env, index, migrants);
+                            }
+                            island.reproduce(mutators...);
+                            if(migrate) {
+                                immigrate(env, index, migrants);
+                            }
+                        }
+                    }
+
+                    /**
+                     * Publish copies of the best candidates of an island.
+                     */
+                    template <typename E> void emigrate(E* env, unsigned int index, unsigned int migrants) {
+                        Island& island = *_islands[index];
+                        C** batch = new C*[migrants];
+                        for(unsigned int i = 0; i < migrants; ++i) {
+                            batch[i] = env->clone(island.candidate(i));
+                        }
+                        // Migrants that were not taken in time are outdated.
+                        C** outdated = _outbox[index].exchange(batch, std::memory_order_acq_rel);
+                        if(nullptr != outdated) {
+                            env->release(outdated, migrants);
+                            delete []outdated;
+                        }
+                        _statistics[index].emigrants += migrants;
+                    }
+
+                    /**
+                     * Take the migrants of the source island, if any.
+                     */
+                    template <typename E> void immigrate(E* env, unsigned int index, unsigned int migrants) {
+                        Island& island = *_islands[index];
+                        unsigned int source;
+                        if(Migration::RING == _migration.topology) {
+                            source = (index + _count - 1) % _count;
+                        } else {
+                            Random random(_seed, island.generation(), index, Random::MIGRATION);
+                            source = random.below(_count - 1);
+                            source += source >= index ? 1 : 0;
+                        }
+                        C** batch = _outbox[source].exchange(nullptr, std::memory_order_acq_rel);
+                        if(nullptr != batch) {
+                            island.immigrate(env, batch, migrants);
+                            delete []batch;
+                            _statistics[index].immigrants += migrants;
+                        }
+                    }
+
+                private:
+                    /**
+                     * Random seed.
+                     */
+                    std::uint64_t _seed;
+
+                    /**
+                     * Number of islands.
+                     */
+                    unsigned int _count;
+
+                    /**
+                     * Island engines.
+                     */
+                    Island** _islands;
+
+                    /**
+                     * Published migrants of each island.
+                     */
+                    std::atomic<C**>* _outbox;
+
+                    /**
+                     * Island statistics.
+                     */
+                    IslandStatistics* _statistics;
+
+                    /**
+                     * Migration settings.
+                     */
+                    Migration _migration;
+
+                    /**
+                     * Raised by the first island reaching the minimal error.
+                     */
+                    std::atomic<bool> _done;
+            };
+
+        } // Namespace 'GA'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
@@ -0,0 +1,430 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM_NOVELTY
+#define HEADLESS_LOGIC_GENETIC_ALGORITHM_NOVELTY
+
+#include <utility>
+#include "geneticalgorithm.hpp"
+#include "searchtree.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace GA {
+
+            /**
+             * Novelty search and fitness sharing, niching policy of 'Trivial'.
+             *
+             * Each generation, the environment describes the behaviour of the
+             * whole pool as keys of a search tree, which also holds an archive
+             * of past novel behaviours. Neighbours are found with ball queries
+             * of the tree rather than by comparing every pair, so that a
+             * generation costs about O(n log n) whatever the archive size.
+             * - Novelty is the mean distance to the 'neighbours' nearest
+             *   behaviours of the pool and the archive. The query radius
+             *   starts from the mean distance to the farthest of them at the
+             *   previous generation, and doubles until enough are found.
+             * - The niche count is the sum, over the behaviours of the pool
+             *   within the 'sharing' radius, of 1 - (distance / sharing) ^ alpha,
+             *   the candidate included.
+             * The fitness is 'score * niche - weight * novelty', so that
+             * sharing assumes non-negative scores, and pure novelty search
+             * is obtained with null scores. After each generation, the most
+             * novel behaviours, up to 'admissions' and above 'threshold', enter
+             * the archive, in place of the oldest ones when full.
+             *
+             * Candidates sharing a behaviour are indexed once, with a weight.
+             * Behaviours out of the root region are not indexed: they have
+             * neighbours but are nobody's.
+             *
+             * The environment must implement (thread-safe, called for the whole
+             * pool in parallel):
+             *     void describe(const C*, K&)
+             * @param <C> Candidate.
+             * @param <K> Behaviour, the key of the search tree.
+             * @param <R> Region of the search tree (see 'SearchTree::Node'). The
+             *     root one is set with 'region'.
+             * @param <B> Ball, the search function of the queries. Must be
+             *     default constructible and implement:
+             *     - void set(const K& center, double radius)
+             *     - bool contains(const K&) const
+             *       Keys at a distance up to the radius, bounds included.
+             *     - int contains(const R&) const
+             *     - double distance(const K&, const K&) const
+             * @param <N> Archive size.
+             */
+            template <typename C, typename K, typename R, typename B, unsigned int N = 1024> class Novelty {
+                public:
+                    static const bool enabled = true;
+
+                private:
+                    /**
+                     * Indexed behaviour.
+                     */
+                    class Point {
+                        public:
+                            Point() : weight(0), archived(false) {}
+                            const K& key() const { return _key; }
+                            void key(const K& key) { _key = key; }
+                            K& behaviour() { return _key; }
+                        public:
+                            /** Number of candidates of the pool sharing this behaviour. */
+                            unsigned int weight;
+                            /** Whether it is part of the archive. */
+                            bool         archived;
+                        private:
+                            K            _key;
+                    };
+
+                    typedef SearchTree::Node<K, R, Point> Tree;
+
+                public:
+                    Novelty() : _tree(nullptr), _archive(new Point[N]), _size(0), _next(0),
+                        _neighbours(15), _weight(1.0), _threshold(0.0), _admissions(1),
+                        _sharing(0.0), _alpha(1.0), _radius(1.0), _reach(0.0),
+                        _indexed(0), _capacity(0), _point(nullptr), _slot(nullptr), _novelty(nullptr),
+                        _farthest(nullptr), _threads(0), _buffer(nullptr), _found(nullptr) {}
+
+                    ~Novelty() {
+                        delete _tree;
+                        delete []_archive;
+                        delete []_point;
+                        delete []_slot;
+                        delete []_novelty;
+                        delete []_farthest;
+                        delete []_buffer;
+                        delete []_found;
+                    }
+
+                    /**
+                     * @return Root region of the tree. Behaviours should lie
+                     * within it. To be set before training.
+                     */
+                    R& region() { return _region; }
+
+                    /**
+                     * @return Number of neighbours of the novelty. 15 by default.
+                     */
+                    unsigned int& neighbours() { return _neighbours; }
+
+                    /**
+                     * @return Novelty weight. 0 disables novelty, 1 by default.
+                     */
+                    double& weight() { return _weight; }
+
+                    /**
+                     * @return Minimal novelty to enter the archive. 0 by default.
+                     */
+                    double& threshold() { return _threshold; }
+
+                    /**
+                     * @return Maximal number of behaviours entering the archive
+                     * per generation. 1 by default.
+                     */
+                    unsigned int& admissions() { return _admissions; }
+
+                    /**
+                     * @return Fitness sharing radius. 0, the default, disables
+                     * sharing.
+                     */
+                    double& sharing() { return _sharing; }
+
+                    /**
+                     * @return Shape of the sharing function. 1 (linear) by default.
+                     */
+                    double& alpha() { return _alpha; }
+
+                    /**
+                     * @return Radius of the first novelty queries. 1 by default.
+                     */
+                    double& radius() { return _radius; }
+
+                    /**
+                     * @return Number of archived behaviours.
+                     */
+                    unsigned int archived() const { return _size; }
+
+                    template <typename E> void adjust(E* env, const C* const* pool, const double* scores,
+                            double* fitness, unsigned int count) {
+                        prepare(count);
+                        if(nullptr == _tree) {
+                            _tree = new Tree(&_region);
+                        }
+                        // Describe the pool ...
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < count; ++i) {
+                            env->describe(pool[i], _point[i].behaviour());
+                        }
+                        // ... index it ...
+                        _indexed = _size;
+                        for(unsigned int i = 0; i < count; ++i) {
+                            _slot[i] = index(_point + i);
+                        }
+                        // ... and query neighbours.
+                        double radius = _reach > 0.0 ? _reach : _radius;
+                        unsigned int size = N + count;
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < count; ++i) {
+                            unsigned int thread = Parallel::index();
+                            Point** buffer = _buffer + thread * size;
+                            std::pair<double, unsigned int>* found = _found + thread * size;
+                            _novelty[i] = 0.0;
+                            _farthest[i] = 0.0;
+                            if(_weight > 0.0) {
+                                _novelty[i] = novelty(i, radius, buffer, found);
+                            }
+                            double niche = _sharing > 0.0 ? share(i, buffer) : 1.0;
+                            fitness[i] = scores[i] * niche - _weight * _novelty[i];
+                        }
+                        if(_weight > 0.0) {
+                            double sum = 0.0;
+                            for(unsigned int i = 0; i < count; ++i) {
+                                sum += _farthest[i];
+                            }
+                            _reach = sum > 0.0 ? sum / count : _reach;
+                        }
+                        forget(count);
+                        admit(count);
+                    }
+
+                    template <typename E> void clear(E*) {
+                        delete _tree;
+                        _tree = nullptr;
+                        _size = 0;
+                        _next = 0;
+                        _reach = 0.0;
+                    }
+
+                private:
+                    Novelty(const Novelty&);
+                    Novelty& operator=(const Novelty&);
+
+                    /**
+                     * Grow the per-candidate and per-thread buffers.
+                     */
+                    void prepare(unsigned int count) {
+                        unsigned int threads = Parallel::count();
+                        if(count > _capacity) {
+                            delete []_point;
+                            delete []_slot;
+                            delete []_novelty;
+                            delete []_farthest;
+                            _point = new Point[count];
+                            _slot = new Point*[count];
+                            _novelty = new double[count];
+                            _farthest = new double[count];
+                            _capacity = count;
+                            _threads = 0;
+                        }
+                        if(threads > _threads) {
+                            delete []_buffer;
+                            delete []_found;
+                            _buffer = new Point*[threads * (N + _capacity)];
+                            _found = new std::pair<double, unsigned int>[threads * (N + _capacity)];
+                            _threads = threads;
+                        }
+                    }
+
+                    /**
+                     * Index a behaviour of the pool.
+                     * @return The indexed point holding it, 'nullptr' if out of
+                     * the root region.
+                     */
+                    Point* index(Point* point) {
+                        if(!_region.contains(point->key())) {
+                            return nullptr;
+                        }
+                        B ball;
+                        ball.set(point->key(), 0.0);
+                        if(_tree->retrieve(ball, _buffer, N + _capacity) > 0) {
+                            ++_buffer[0]->weight;
+                            ++_indexed;
+                            return _buffer[0];
+                        }
+                        point->weight = 1;
+                        point->archived = false;
+                        _tree->add(point);
+                        ++_indexed;
+                        return point;
+                    }
+
+                    /**
+                     * @return Weight of a point in novelty queries.
+                     */
+                    static unsigned int weight(const Point* point) {
+                        return point->weight + (point->archived ? 1 : 0);
+                    }
+
+                    /**
+                     * @return Mean distance of a candidate to its nearest neighbours.
+                     */
+                    double novelty(unsigned int index, double radius, Point** buffer,
+                            std::pair<double, unsigned int>* found) {
+                        const K& key = _point[index].key();
+                        Point* self = _slot[index];
+                        unsigned int others = _indexed - (nullptr != self ? 1 : 0);
+                        unsigned int wanted = _neighbours < others ? _neighbours : others;
+                        if(0 == wanted) {
+                            return 0.0;
+                        }
+                        B ball;
+                        unsigned int retrieved;
+                        for(;;) {
+                            ball.set(key, radius);
+                            retrieved = _tree->retrieve(ball, buffer, N + _capacity);
+                            unsigned int total = 0;
+                            for(unsigned int i = 0; i < retrieved; ++i) {
+                                total += weight(buffer[i]);
+                            }
+                            total -= nullptr != self ? 1 : 0;
+                            if(total >= wanted || !(radius < std::numeric_limits<double>::max())) {
+                                break;
+                            }
+                            radius *= 2.0;
+                        }
+                        for(unsigned int i = 0; i < retrieved; ++i) {
+                            found[i].first = ball.distance(key, buffer[i]->key());
+                            found[i].second = weight(buffer[i]) - (buffer[i] == self ? 1 : 0);
+                        }
+                        std::sort(found, found + retrieved);
+                        double sum = 0.0;
+                        unsigned int remaining = wanted;
+                        for(unsigned int i = 0; i < retrieved && remaining > 0; ++i) {
+                            unsigned int taken = found[i].second < remaining ? found[i].second : remaining;
+                            sum += found[i].first * taken;
+                            remaining -= taken;
+                            _farthest[index] = taken > 0 ? found[i].first : _farthest[index];
+                        }
+                        return remaining < wanted ? sum / (wanted - remaining) : 0.0;
+                    }
+
+                    /**
+                     * @return Niche count of a candidate.
+                     */
+                    double share(unsigned int index, Point** buffer) const {
+                        const K& key = _point[index].key();
+                        B ball;
+                        ball.set(key, _sharing);
+                        unsigned int retrieved = _tree->retrieve(ball, buffer, N + _capacity);
+                        double niche = nullptr != _slot[index] ? 0.0 : 1.0;
+                        for(unsigned int i = 0; i < retrieved; ++i) {
+                            double distance = ball.distance(key, buffer[i]->key());
+                            if(distance < _sharing) {
+                                niche += buffer[i]->weight * (1.0 - std::pow(distance / _sharing, _alpha));
+                            }
+                        }
+                        return niche;
+                    }
+
+                    /**
+                     * Remove the pool from the tree.
+                     */
+                    void forget(unsigned int count) {
+                        for(unsigned int i = 0; i < count; ++i) {
+                            Point* slot = _slot[i];
+                            if(nullptr == slot) {
+                                continue;
+                            }
+                            if(slot == _point + i) {
+                                _tree->remove(slot);
+                            } else {
+                                --slot->weight;
+                            }
+                        }
+                    }
+
+                    /**
+                     * Archive the most novel behaviours of the pool. Behaviours
+                     * already archived or out of the root region are not.
+                     */
+                    void admit(unsigned int count) {
+                        // Candidates are ranked in the buffer of the first thread.
+                        std::pair<double, unsigned int>* ranked = _found;
+                        unsigned int eligible = 0;
+                        for(unsigned int i = 0; i < count; ++i) {
+                            if(_slot[i] == _point + i && _novelty[i] > _threshold) {
+                                ranked[eligible].first = -_novelty[i];
+                                ranked[eligible++].second = i;
+                            }
+                        }
+                        unsigned int admitted = _admissions < eligible ? _admissions : eligible;
+                        std::partial_sort(ranked, ranked + admitted, ranked + eligible);
+                        for(unsigned int i = 0; i < admitted; ++i) {
+                            Point& point = _archive[_next];
+                            if(_size == N) {
+                                _tree->remove(&point);
+                            } else {
+                                ++_size;
+                            }
+                            point.key(_point[ranked[i].second].key());
+                            point.weight = 0;
+                            point.archived = true;
+                            _tree->add(&point);
+                            _next = (_next + 1) % N;
+                        }
+                    }
+
+                private:
+                    /** Root region. */
+                    R                                 _region;
+                    /** Archive and pool behaviours. */
+                    Tree*                             _tree;
+                    /** Archived behaviours. */
+                    Point*                            _archive;
+                    /** Number of archived behaviours. */
+                    unsigned int                      _size;
+                    /** Next archive slot. */
+                    unsigned int                      _next;
+                    /** Number of neighbours of the novelty. */
+                    unsigned int                      _neighbours;
+                    /** Novelty weight. */
+                    double                            _weight;
+                    /** Minimal novelty to enter the archive. */
+                    double                            _threshold;
+                    /** Maximal number of admissions per generation. */
+                    unsigned int                      _admissions;
+                    /** Fitness sharing radius. */
+                    double                            _sharing;
+                    /** Sharing function shape. */
+                    double                            _alpha;
+                    /** Radius of the first queries. */
+                    double                            _radius;
+                    /** Mean distance to the farthest neighbour, last generation. */
+                    double                            _reach;
+                    /** Indexed weight, i.e. number of indexed candidates and archived behaviours. */
+                    unsigned int                      _indexed;
+                    /** Size of the per-candidate buffers. */
+                    unsigned int                      _capacity;
+                    /** Behaviours of the pool. */
+                    Point*                            _point;
+                    /** Indexed point of each candidate. */
+                    Point**                           _slot;
+                    /** Novelty of each candidate. */
+                    double*                           _novelty;
+                    /** Distance of each candidate to its farthest neighbour. */
+                    double*                           _farthest;
+                    /** Number of threads of the per-thread buffers. */
+                    unsigned int                      _threads;
+                    /** Query results, per thread. */
+                    Point**                           _buffer;
+                    /** Neighbour distances and weights, per thread. */
+                    std::pair<double, unsigned int>*  _found;
+            };
+
+        } // Namespace 'GA'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
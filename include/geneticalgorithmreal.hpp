@@ -0,0 +1,847 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM_REAL
+#define HEADLESS_LOGIC_GENETIC_ALGORITHM_REAL
+
+#include <stdexcept>
+#include "geneticalgorithm.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace GA {
+
+            /**
+             * Dense row-major matrix of doubles. Rows are padded to a
+             * multiple of 4 doubles, so that they all share the alignment of
+             * the first one.
+             */
+            class Matrix {
+                public:
+                    Matrix(unsigned int rows, unsigned int columns) : _rows(rows), _columns(columns),
+                        _stride((columns + 3) & ~3u), _data(new double[rows * _stride]()) {}
+
+                    ~Matrix() {
+                        delete []_data;
+                    }
+
+                    double* operator[](unsigned int row) { return _data + row * _stride; }
+                    const double* operator[](unsigned int row) const { return _data + row * _stride; }
+
+                    unsigned int rows() const { return _rows; }
+                    unsigned int columns() const { return _columns; }
+
+                    /**
+                     * @return Distance between two rows, in doubles.
+                     */
+                    unsigned int stride() const { return _stride; }
+
+                private:
+                    Matrix(const Matrix&);
+                    Matrix& operator=(const Matrix&);
+
+                private:
+                    unsigned int _rows;
+                    unsigned int _columns;
+                    unsigned int _stride;
+                    double*      _data;
+            };
+
+            /**
+             * Dense linear algebra and sampling helpers of the real-vector
+             * engines.
+             */
+            namespace Dense {
+                /**
+                 * @return Standard normal number (Box-Muller).
+                 */
+                inline double gaussian(Random& random) {
+                    double radius = std::sqrt(-2.0 * std::log(1.0 - random.uniform()));
+                    return radius * std::cos(6.283185307179586 * random.uniform());
+                }
+
+                /**
+                 * @return Dot product.
+                 */
+                inline double dot(const double* a, const double* b, unsigned int count) {
+                    double sum = 0.0;
+                    #pragma omp simd reduction(+:sum)
+                    for(unsigned int i = 0; i < count; ++i) {
+                        sum += a[i] * b[i];
+                    }
+                    return sum;
+                }
+
+                /**
+                 * y += a * x.
+                 */
+                inline void axpy(double a, const double* x, double* y, unsigned int count) {
+                    #pragma omp simd
+                    for(unsigned int i = 0; i < count; ++i) {
+                        y[i] += a * x[i];
+                    }
+                }
+
+                /**
+                 * Eigen decomposition of a symmetric matrix, by cyclic Jacobi
+                 * rotations. Fine for the dimensions evolution strategies
+                 * deal with (up to a few hundreds).
+                 * @param matrix Symmetric matrix. It is destroyed.
+                 * @param vectors Receives the eigenvectors, as columns.
+                 * @param values Receives the eigenvalues.
+                 */
+                inline void eigen(Matrix& matrix, Matrix& vectors, double* values) {
+                    unsigned int n = matrix.rows();
+                    for(unsigned int i = 0; i < n; ++i) {
+                        std::fill(vectors[i], vectors[i] + n, 0.0);
+                        vectors[i][i] = 1.0;
+                    }
+                    for(unsigned int sweep = 0; sweep < 64; ++sweep) {
+                        double off = 0.0;
+                        double diagonal = 0.0;
+                        for(unsigned int p = 0; p < n; ++p) {
+                            diagonal += matrix[p][p] * matrix[p][p];
+                            for(unsigned int q = p + 1; q < n; ++q) {
+                                off += matrix[p][q] * matrix[p][q];
+                            }
+                        }
+                        if(off <= 1e-30 * diagonal) {
+                            break;
+                        }
+                        for(unsigned int p = 0; p < n; ++p) {
+                            for(unsigned int q = p + 1; q < n; ++q) {
+                                double apq = matrix[p][q];
+                                if(0.0 == apq) {
+                                    continue;
+                                }
+                                double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * apq);
+                                double t = 1.0 / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                                t = theta < 0.0 ? -t : t;
+                                double c = 1.0 / std::sqrt(t * t + 1.0);
+                                double s = t * c;
+                                // Columns, then rows: matrix = P' * matrix * P.
+                                for(unsigned int k = 0; k < n; ++k) {
+                                    double kp = matrix[k][p];
+                                    double kq = matrix[k][q];
+                                    matrix[k][p] = c * kp - s * kq;
+                                    matrix[k][q] = s * kp + c * kq;
+                                }
+                                double* rowP = matrix[p];
+                                double* rowQ = matrix[q];
+                                #pragma omp simd
+                                for(unsigned int k = 0; k < n; ++k) {
+                                    double pk = rowP[k];
+                                    double qk = rowQ[k];
+                                    rowP[k] = c * pk - s * qk;
+                                    rowQ[k] = s * pk + c * qk;
+                                }
+                                for(unsigned int k = 0; k < n; ++k) {
+                                    double kp = vectors[k][p];
+                                    double kq = vectors[k][q];
+                                    vectors[k][p] = c * kp - s * kq;
+                                    vectors[k][q] = s * kp + c * kq;
+                                }
+                            }
+                        }
+                    }
+                    for(unsigned int i = 0; i < n; ++i) {
+                        values[i] = matrix[i][i];
+                    }
+                }
+
+                /**
+                 * Evaluate rows one by one.
+                 */
+                template <typename E> void evaluate(E* env, const double* const* rows, unsigned int count,
+                        double* scores, std::uint64_t seed, unsigned int generation, std::false_type) {
+                    #pragma omp parallel for
+                    for(unsigned int i = 0; i < count; ++i) {
+                        Random random(seed, generation, i, Random::EVALUATION);
+                        scores[i] = Concept::evaluate(env, rows[i], random, 0);
+                    }
+                }
+
+                /**
+                 * Evaluate rows as a batch.
+                 */
+                template <typename E> void evaluate(E* env, const double* const* rows, unsigned int count,
+                        double* scores, std::uint64_t, unsigned int, std::true_type) {
+                    Concept::batch(env, rows, count, scores);
+                }
+            } // Namespace 'Dense'
+
+            /**
+             * Differential evolution.
+             * The population is a dense matrix, one candidate per row. Each
+             * generation, every candidate gets a trial vector out of a
+             * mutant (a base vector plus the weighted difference of two
+             * others) and a binomial crossover, and is replaced by it if it
+             * scores at least as well. Trial components out of the bounds are
+             * brought back halfway between the candidate and the bound.
+             *
+             * Trials are built and evaluated in parallel, each candidate with
+             * its own 'Random' streams: for a given seed, results are
+             * identical whatever the number of threads.
+             *
+             * The environment must define:
+             *     - double evaluate(const double*)
+             *       or double evaluate(const double*, Random&)
+             *     and optionally the batch evaluation:
+             *     - void evaluate(const double* const*, unsigned int, double*)
+             * Vectors have the dimension of the engine.
+             */
+            class Differential {
+                public:
+                    /**
+                     * Base vector of the mutants.
+                     */
+                    enum Strategy {
+                        /** DE/rand/1: a random candidate. */
+                        RAND,
+                        /** DE/best/1: the best candidate. */
+                        BEST,
+                        /** DE/current-to-best/1: the candidate, moved toward the best one. */
+                        CURRENT_TO_BEST
+                    };
+
+                public:
+                    /**
+                     * Constructor. The seed is drawn from 'std::random_device'.
+                     * @param dimension Vector dimension.
+                     * @param pSize Population size, at least 4.
+                     * @throws std::invalid_argument If the population is too small.
+                     */
+                    Differential(unsigned int dimension, unsigned int pSize) :
+                        Differential(dimension, pSize, Random::entropy()) {}
+
+                    /**
+                     * Constructor.
+                     * @param dimension Vector dimension.
+                     * @param pSize Population size, at least 4.
+                     * @param seed Random seed.
+                     * @throws std::invalid_argument If the population is too small.
+                     */
+                    Differential(unsigned int dimension, unsigned int pSize, std::uint64_t seed) :
+                        _seed(seed), _dimension(dimension), _count(pSize), _population(pSize, dimension),
+                        _trial(pSize, dimension), _weight(0.5), _crossover(0.9), _strategy(RAND),
+                        _generation(0), _evaluations(0), _best(0) {
+                        // Mutants need three candidates other than the current one.
+                        if(pSize < 4) {
+                            throw std::invalid_argument("Differential evolution needs at least 4 candidates.");
+                        }
+                        _score = new double[pSize];
+                        _trialScore = new double[pSize];
+                        _rows = new const double*[pSize];
+                        _lower = new double[dimension];
+                        _upper = new double[dimension];
+                    }
+
+                    /**
+                     * Destructor.
+                     */
+                    ~Differential() {
+                        delete []_score;
+                        delete []_trialScore;
+                        delete []_rows;
+                        delete []_lower;
+                        delete []_upper;
+                    }
+
+                    /**
+                     * @return Differential weight (F). 0.5 by default.
+                     */
+                    double& weight() { return _weight; }
+
+                    /**
+                     * @return Crossover rate (CR). 0.9 by default.
+                     */
+                    double& crossover() { return _crossover; }
+
+                    /**
+                     * @return Mutant strategy. 'RAND' by default.
+                     */
+                    Strategy& strategy() { return _strategy; }
+
+                    /**
+                     * @return Random seed.
+                     */
+                    std::uint64_t seed() const { return _seed; }
+
+                    /**
+                     * Training.
+                     * @param env Environment.
+                     * @param maxGen Maximum number of generations.
+                     * @param minErr Minimal accepable error.
+                     * @param lower Lower bounds, one per dimension.
+                     * @param upper Upper bounds, one per dimension. The initial
+                     * population is uniform within the bounds.
+                     * @return Best score.
+                     */
+                    template <typename E> double train(E* env, unsigned int maxGen, double minErr,
+                            const double* lower, const double* upper) {
+                        std::copy(lower, lower + _dimension, _lower);
+                        std::copy(upper, upper + _dimension, _upper);
+                        _generation = 0;
+                        _evaluations = 0;
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            Random random(_seed, 0, i, Random::INITIALIZATION);
+                            double* row = _population[i];
+                            for(unsigned int j = 0; j < _dimension; ++j) {
+                                row[j] = _lower[j] + (_upper[j] - _lower[j]) * random.uniform();
+                            }
+                        }
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _rows[i] = _population[i];
+                        }
+                        Dense::evaluate(env, _rows, _count, _score, _seed, 0, Concept::Batch<E, double>());
+                        _evaluations += _count;
+                        elect();
+                        while(_generation < maxGen && _score[_best] > minErr) {
+                            ++_generation;
+                            breed();
+                            Dense::evaluate(env, _rows, _count, _trialScore, _seed, _generation,
+                                    Concept::Batch<E, double>());
+                            _evaluations += _count;
+                            select();
+                            elect();
+                        }
+                        return _score[_best];
+                    }
+
+                    /**
+                     * @return Best vector of the last training.
+                     */
+                    const double* best() const { return _population[_best]; }
+
+                    /**
+                     * @return Best score of the last training.
+                     */
+                    double score() const { return _score[_best]; }
+
+                    /**
+                     * @return Population, one candidate per row.
+                     */
+                    const Matrix& population() const { return _population; }
+
+                    /**
+                     * @param index Candidate index.
+                     * @return Candidate score.
+                     */
+                    double score(unsigned int index) const { return _score[index]; }
+
+                    /**
+                     * @return Number of generations of the last training.
+                     */
+                    unsigned int generation() const { return _generation; }
+
+                    /**
+                     * @return Number of evaluations of the last training.
+                     */
+                    unsigned long long evaluations() const { return _evaluations; }
+
+                private:
+                    Differential(const Differential&);
+                    Differential& operator=(const Differential&);
+
+                    /**
+                     * Build the trial vectors.
+                     */
+                    void breed() {
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            Random random(_seed, _generation, i);
+                            // Three distinct candidates, other than the current one.
+                            unsigned int pick[3];
+                            for(unsigned int k = 0; k < 3; ++k) {
+                                bool taken;
+                                do {
+                                    pick[k] = random.below(_count);
+                                    taken = pick[k] == i;
+                                    for(unsigned int l = 0; l < k; ++l) {
+                                        taken |= pick[k] == pick[l];
+                                    }
+                                } while(taken);
+                            }
+                            const double* current = _population[i];
+                            const double* best = _population[_best];
+                            const double* a = _population[pick[0]];
+                            const double* b = _population[pick[1]];
+                            const double* c = _population[pick[2]];
+                            double* trial = _trial[i];
+                            double weight = _weight;
+                            unsigned int n = _dimension;
+                            // Mutant ...
+                            switch(_strategy) {
+                                case RAND:
+                                    #pragma omp simd
+                                    for(unsigned int j = 0; j < n; ++j) {
+                                        trial[j] = a[j] + weight * (b[j] - c[j]);
+                                    }
+                                    break;
+                                case BEST:
+                                    #pragma omp simd
+                                    for(unsigned int j = 0; j < n; ++j) {
+                                        trial[j] = best[j] + weight * (a[j] - b[j]);
+                                    }
+                                    break;
+                                case CURRENT_TO_BEST:
+                                    #pragma omp simd
+                                    for(unsigned int j = 0; j < n; ++j) {
+                                        trial[j] = current[j] + weight * (best[j] - current[j] + a[j] - b[j]);
+                                    }
+                                    break;
+                            }
+                            // ... crossover, at least one component from the mutant ...
+                            unsigned int forced = random.below(n);
+                            for(unsigned int j = 0; j < n; ++j) {
+                                if(j != forced && random.uniform() >= _crossover) {
+                                    trial[j] = current[j];
+                                }
+                            }
+                            // ... and bounds.
+                            const double* lower = _lower;
+                            const double* upper = _upper;
+                            #pragma omp simd
+                            for(unsigned int j = 0; j < n; ++j) {
+                                double value = trial[j];
+                                value = value < lower[j] ? 0.5 * (lower[j] + current[j]) : value;
+                                value = value > upper[j] ? 0.5 * (upper[j] + current[j]) : value;
+                                trial[j] = value;
+                            }
+                            _rows[i] = trial;
+                        }
+                    }
+
+                    /**
+                     * Replace candidates by their trial if not worse.
+                     */
+                    void select() {
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_trialScore[i] <= _score[i]) {
+                                std::copy(_trial[i], _trial[i] + _dimension, _population[i]);
+                                _score[i] = _trialScore[i];
+                            }
+                        }
+                    }
+
+                    /**
+                     * Find the best candidate, the first one on ties.
+                     */
+                    void elect() {
+                        _best = 0;
+                        for(unsigned int i = 1; i < _count; ++i) {
+                            _best = _score[i] < _score[_best] ? i : _best;
+                        }
+                    }
+
+                private:
+                    /** Random seed. */
+                    std::uint64_t      _seed;
+                    /** Vector dimension. */
+                    unsigned int       _dimension;
+                    /** Population size. */
+                    unsigned int       _count;
+                    /** Population. */
+                    Matrix             _population;
+                    /** Trial vectors. */
+                    Matrix             _trial;
+                    /** Population scores. */
+                    double*            _score;
+                    /** Trial scores. */
+                    double*            _trialScore;
+                    /** Rows to evaluate. */
+                    const double**     _rows;
+                    /** Lower bounds. */
+                    double*            _lower;
+                    /** Upper bounds. */
+                    double*            _upper;
+                    /** Differential weight. */
+                    double             _weight;
+                    /** Crossover rate. */
+                    double             _crossover;
+                    /** Mutant strategy. */
+                    Strategy           _strategy;
+                    /** Current generation. */
+                    unsigned int       _generation;
+                    /** Number of evaluations. */
+                    unsigned long long _evaluations;
+                    /** Index of the best candidate. */
+                    unsigned int       _best;
+            };
+
+            /**
+             * Covariance matrix adaptation evolution strategy, (mu/mu_w, lambda)
+             * with rank-one and rank-mu updates and cumulative step-size
+             * adaptation. Samples, their steps and the covariance matrix are
+             * dense matrices; the eigen decomposition of the covariance is
+             * only refreshed every few generations, as usual.
+             *
+             * Sampling and evaluation are parallel, each sample with its own
+             * 'Random' streams, and the covariance update is parallel over
+             * rows: for a given seed, results are identical whatever the
+             * number of threads.
+             *
+             * The environment is the one of 'Differential'. Bounds only set
+             * the initial distribution: samples are not bounded.
+             */
+            class CMAES {
+                public:
+                    /**
+                     * Constructor. The seed is drawn from 'std::random_device'.
+                     * @param dimension Vector dimension.
+                     * @param pSize Number of samples per generation (lambda), at
+                     * least 2. 4 + 3 ln(dimension) is the usual choice.
+                     * @throws std::invalid_argument If there are too few samples.
+                     */
+                    CMAES(unsigned int dimension, unsigned int pSize) : CMAES(dimension, pSize, Random::entropy()) {}
+
+                    /**
+                     * Constructor.
+                     * @param dimension Vector dimension.
+                     * @param pSize Number of samples per generation (lambda), at least 2.
+                     * @param seed Random seed.
+                     * @throws std::invalid_argument If there are too few samples.
+                     */
+                    CMAES(unsigned int dimension, unsigned int pSize, std::uint64_t seed) :
+                        _seed(seed), _dimension(dimension), _count(pSize), _parents(pSize / 2),
+                        _sample(pSize, dimension), _step(pSize, dimension), _covariance(dimension, dimension),
+                        _basis(dimension, dimension), _work(dimension, dimension), _sigma(0.0), _step0(0.0),
+                        _generation(0), _evaluations(0), _bestScore(0.0) {
+                        // The mean is recombined from the best half: at least one parent.
+                        if(pSize < 2) {
+                            throw std::invalid_argument("CMA-ES needs at least 2 samples per generation.");
+                        }
+                        _score = new double[pSize];
+                        _order = new unsigned int[pSize];
+                        _rows = new const double*[pSize];
+                        _weights = new double[_parents];
+                        _mean = new double[dimension];
+                        _scale = new double[dimension];
+                        _pathC = new double[dimension];
+                        _pathS = new double[dimension];
+                        _shift = new double[dimension];
+                        _scratch = new double[dimension];
+                        _best = new double[dimension];
+
+                        // Default strategy parameters.
+                        double n = dimension;
+                        double sum = 0.0;
+                        for(unsigned int i = 0; i < _parents; ++i) {
+                            _weights[i] = std::log(_parents + 0.5) - std::log(i + 1.0);
+                            sum += _weights[i];
+                        }
+                        double squares = 0.0;
+                        for(unsigned int i = 0; i < _parents; ++i) {
+                            _weights[i] /= sum;
+                            squares += _weights[i] * _weights[i];
+                        }
+                        _effective = 1.0 / squares;
+                        _cs = (_effective + 2.0) / (n + _effective + 5.0);
+                        _damping = 1.0 + 2.0 * std::max(0.0, std::sqrt((_effective - 1.0) / (n + 1.0)) - 1.0) + _cs;
+                        _cc = (4.0 + _effective / n) / (n + 4.0 + 2.0 * _effective / n);
+                        _c1 = 2.0 / ((n + 1.3) * (n + 1.3) + _effective);
+                        _cmu = std::min(1.0 - _c1,
+                                2.0 * (_effective - 2.0 + 1.0 / _effective) / ((n + 2.0) * (n + 2.0) + _effective));
+                        _chi = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+                        _period = static_cast<unsigned int>(1.0 / ((_c1 + _cmu) * n * 10.0));
+                        _period = _period < 1 ? 1 : _period;
+                    }
+
+                    /**
+                     * Destructor.
+                     */
+                    ~CMAES() {
+                        delete []_score;
+                        delete []_order;
+                        delete []_rows;
+                        delete []_weights;
+                        delete []_mean;
+                        delete []_scale;
+                        delete []_pathC;
+                        delete []_pathS;
+                        delete []_shift;
+                        delete []_scratch;
+                        delete []_best;
+                    }
+
+                    /**
+                     * @return Initial step size. 0, the default, takes 0.3 times
+                     * the mean width of the bounds.
+                     */
+                    double& sigma() { return _step0; }
+
+                    /**
+                     * @return Random seed.
+                     */
+                    std::uint64_t seed() const { return _seed; }
+
+                    /**
+                     * Training. See 'Differential::train'. The initial mean is the
+                     * center of the bounds, and the initial covariance is
+                     * diagonal, scaled to their widths.
+                     * @return Best score.
+                     */
+                    template <typename E> double train(E* env, unsigned int maxGen, double minErr,
+                            const double* lower, const double* upper) {
+                        unsigned int n = _dimension;
+                        double width = 0.0;
+                        for(unsigned int i = 0; i < n; ++i) {
+                            width += (upper[i] - lower[i]) / n;
+                        }
+                        for(unsigned int i = 0; i < n; ++i) {
+                            _mean[i] = 0.5 * (lower[i] + upper[i]);
+                            _pathC[i] = 0.0;
+                            _pathS[i] = 0.0;
+                            std::fill(_covariance[i], _covariance[i] + n, 0.0);
+                            double scale = (upper[i] - lower[i]) / width;
+                            _covariance[i][i] = scale * scale;
+                        }
+                        _sigma = _step0 > 0.0 ? _step0 : 0.3 * width;
+                        _generation = 0;
+                        _evaluations = 0;
+                        _bestScore = std::numeric_limits<double>::infinity();
+                        decompose();
+                        while(_generation < maxGen && _bestScore > minErr) {
+                            sample();
+                            Dense::evaluate(env, _rows, _count, _score, _seed, _generation,
+                                    Concept::Batch<E, double>());
+                            _evaluations += _count;
+                            _ranking.rank(_score, _order, _count, _parents);
+                            if(_score[_order[0]] < _bestScore) {
+                                _bestScore = _score[_order[0]];
+                                std::copy(_sample[_order[0]], _sample[_order[0]] + n, _best);
+                            }
+                            ++_generation;
+                            update();
+                            if(0 == _generation % _period) {
+                                decompose();
+                            }
+                        }
+                        return _bestScore;
+                    }
+
+                    /**
+                     * @return Best vector of the last training.
+                     */
+                    const double* best() const { return _best; }
+
+                    /**
+                     * @return Best score of the last training.
+                     */
+                    double score() const { return _bestScore; }
+
+                    /**
+                     * @return Distribution mean.
+                     */
+                    const double* mean() const { return _mean; }
+
+                    /**
+                     * @return Current step size.
+                     */
+                    double step() const { return _sigma; }
+
+                    /**
+                     * @return Covariance matrix.
+                     */
+                    const Matrix& covariance() const { return _covariance; }
+
+                    /**
+                     * @return Number of generations of the last training.
+                     */
+                    unsigned int generation() const { return _generation; }
+
+                    /**
+                     * @return Number of evaluations of the last training.
+                     */
+                    unsigned long long evaluations() const { return _evaluations; }
+
+                private:
+                    CMAES(const CMAES&);
+                    CMAES& operator=(const CMAES&);
+
+                    /**
+                     * Refresh the basis and scales out of the covariance matrix.
+                     */
+                    void decompose() {
+                        unsigned int n = _dimension;
+                        for(unsigned int i = 0; i < n; ++i) {
+                            std::copy(_covariance[i], _covariance[i] + n, _work[i]);
+                        }
+                        Dense::eigen(_work, _basis, _scale);
+                        for(unsigned int i = 0; i < n; ++i) {
+                            _scale[i] = std::sqrt(_scale[i] > 1e-300 ? _scale[i] : 1e-300);
+                        }
+                    }
+
+                    /**
+                     * Draw the samples: step = basis * (scale . z), sample =
+                     * mean + sigma * step. Sample rows are used as scratch.
+                     */
+                    void sample() {
+                        unsigned int n = _dimension;
+                        #pragma omp parallel for
+                        for(unsigned int k = 0; k < _count; ++k) {
+                            Random random(_seed, _generation, k);
+                            double* x = _sample[k];
+                            double* y = _step[k];
+                            for(unsigned int j = 0; j < n; ++j) {
+                                x[j] = _scale[j] * Dense::gaussian(random);
+                            }
+                            for(unsigned int j = 0; j < n; ++j) {
+                                y[j] = Dense::dot(_basis[j], x, n);
+                            }
+                            double sigma = _sigma;
+                            const double* mean = _mean;
+                            #pragma omp simd
+                            for(unsigned int j = 0; j < n; ++j) {
+                                x[j] = mean[j] + sigma * y[j];
+                            }
+                            _rows[k] = x;
+                        }
+                    }
+
+                    /**
+                     * Move the mean and adapt the paths, the covariance matrix
+                     * and the step size.
+                     */
+                    void update() {
+                        unsigned int n = _dimension;
+                        // Mean shift, in steps.
+                        std::fill(_shift, _shift + n, 0.0);
+                        for(unsigned int i = 0; i < _parents; ++i) {
+                            Dense::axpy(_weights[i], _step[_order[i]], _shift, n);
+                        }
+                        Dense::axpy(_sigma, _shift, _mean, n);
+
+                        // Conjugate evolution path: basis * scale^-1 * basis' * shift.
+                        std::fill(_scratch, _scratch + n, 0.0);
+                        for(unsigned int j = 0; j < n; ++j) {
+                            Dense::axpy(_shift[j], _basis[j], _scratch, n);
+                        }
+                        for(unsigned int j = 0; j < n; ++j) {
+                            _scratch[j] /= _scale[j];
+                        }
+                        double normalization = std::sqrt(_cs * (2.0 - _cs) * _effective);
+                        for(unsigned int j = 0; j < n; ++j) {
+                            _pathS[j] = (1.0 - _cs) * _pathS[j]
+                                + normalization * Dense::dot(_basis[j], _scratch, n);
+                        }
+                        double norm = std::sqrt(Dense::dot(_pathS, _pathS, n));
+                        double correction = std::sqrt(1.0 - std::pow(1.0 - _cs, 2.0 * _generation));
+                        bool stalled = norm / correction / _chi >= 1.4 + 2.0 / (n + 1.0);
+
+                        // Covariance path and matrix.
+                        normalization = stalled ? 0.0 : std::sqrt(_cc * (2.0 - _cc) * _effective);
+                        for(unsigned int j = 0; j < n; ++j) {
+                            _pathC[j] = (1.0 - _cc) * _pathC[j] + normalization * _shift[j];
+                        }
+                        double decay = 1.0 - _c1 - _cmu + (stalled ? _c1 * _cc * (2.0 - _cc) : 0.0);
+                        #pragma omp parallel for
+                        for(unsigned int r = 0; r < n; ++r) {
+                            double* row = _covariance[r];
+                            double one = _c1 * _pathC[r];
+                            const double* path = _pathC;
+                            #pragma omp simd
+                            for(unsigned int c = 0; c < n; ++c) {
+                                row[c] = decay * row[c] + one * path[c];
+                            }
+                            for(unsigned int i = 0; i < _parents; ++i) {
+                                const double* y = _step[_order[i]];
+                                Dense::axpy(_cmu * _weights[i] * y[r], y, row, n);
+                            }
+                        }
+
+                        // Step size.
+                        _sigma *= std::exp((_cs / _damping) * (norm / _chi - 1.0));
+                    }
+
+                private:
+                    /** Random seed. */
+                    std::uint64_t      _seed;
+                    /** Vector dimension. */
+                    unsigned int       _dimension;
+                    /** Number of samples (lambda). */
+                    unsigned int       _count;
+                    /** Number of recombined samples (mu). */
+                    unsigned int       _parents;
+                    /** Samples. */
+                    Matrix             _sample;
+                    /** Sample steps, before the step size. */
+                    Matrix             _step;
+                    /** Covariance matrix. */
+                    Matrix             _covariance;
+                    /** Eigenvectors of the covariance matrix, as columns. */
+                    Matrix             _basis;
+                    /** Decomposition scratch. */
+                    Matrix             _work;
+                    /** Sample scores. */
+                    double*            _score;
+                    /** Sample ranking. */
+                    unsigned int*      _order;
+                    /** Rows to evaluate. */
+                    const double**     _rows;
+                    /** Recombination weights. */
+                    double*            _weights;
+                    /** Distribution mean. */
+                    double*            _mean;
+                    /** Square roots of the eigenvalues of the covariance matrix. */
+                    double*            _scale;
+                    /** Covariance evolution path. */
+                    double*            _pathC;
+                    /** Conjugate evolution path. */
+                    double*            _pathS;
+                    /** Weighted mean of the selected steps. */
+                    double*            _shift;
+                    /** Scratch vector. */
+                    double*            _scratch;
+                    /** Best vector. */
+                    double*            _best;
+                    /** Step size. */
+                    double             _sigma;
+                    /** Initial step size. */
+                    double             _step0;
+                    /** Variance effective selection mass. */
+                    double             _effective;
+                    /** Step-size cumulation. */
+                    double             _cs;
+                    /** Step-size damping. */
+                    double             _damping;
+                    /** Covariance cumulation. */
+                    double             _cc;
+                    /** Rank-one learning rate. */
+                    double             _c1;
+                    /** Rank-mu learning rate. */
+                    double             _cmu;
+                    /** Expected norm of a standard normal vector. */
+                    double             _chi;
+                    /** Generations between eigen decompositions. */
+                    unsigned int       _period;
+                    /** Current generation. */
+                    unsigned int       _generation;
+                    /** Number of evaluations. */
+                    unsigned long long _evaluations;
+                    /** Best score. */
+                    double             _bestScore;
+                    /** Sample ranking policy. */
+                    Truncation         _ranking;
+            };
+
+        } // Namespace 'GA'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
@@ -0,0 +1,418 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM_STEADY_STATE
+#define HEADLESS_LOGIC_GENETIC_ALGORITHM_STEADY_STATE
+
+#include <mutex>
+#include "geneticalgorithm.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace GA {
+            namespace Concept {
+                template <typename E, typename C>
+                    auto copy(E* env, const C* source, C* target, int)
+                    -> decltype(env->copy(source, target), void()) {
+                        env->copy(source, target);
+                    }
+
+                template <typename E, typename C>
+                    void copy(E*, const C* source, C* target, long) {
+                        *target = *source;
+                    }
+            } // Namespace 'Concept'
+
+            /**
+             * Steady-state asynchronous GA.
+             * There are no generations: each worker thread loops on
+             * 1. breed an offspring out of the ranked pool,
+             * 2. evaluate it,
+             * 3. insert it in the pool, in place of the worst candidate,
+             *    unless it is even worse.
+             * Workers never wait for each other's evaluations, which suits
+             * evaluations of widely varying cost.
+             *
+             * The ranked pool, the selection policy and the memo table are
+             * protected by a single lock. Parents are drawn and copied into
+             * worker buffers under it; mutation and evaluation run outside.
+             * Selection tables are rebuilt every 'refresh()' insertions
+             * rather than after each one, so parents are drawn from a
+             * slightly stale ranking in between. The replaced candidate
+             * becomes the worker's next offspring, so no allocation happens
+             * after start.
+             *
+             * Random streams are bound to the birth number of offspring.
+             * Which parents they see depends on thread scheduling, though, so
+             * results are not reproducible with several threads.
+             *
+             * Concepts are the ones of 'Trivial', plus a way to copy parents:
+             * the environment method 'void copy(const C* source, C* target)'
+             * if present, copy assignment of 'C' otherwise. The environment
+             * 'evaluate' method and the mutators are called concurrently; the
+             * other ones are called under the lock. Batch evaluation, if any,
+             * is only used for the initial pool: offspring are evaluated one
+             * by one, as soon as bred.
+             * @param <C> Candidates to be evaluated and modified.
+             * @param <H> Memo table. 'NoMemo' or 'Memo'.
+             * @param <S> Selection policy. Only 'prepare' and 'select' are used,
+             *     the pool being always sorted.
+             */
+            template <typename C, typename H = NoMemo, typename S = Truncation> class SteadyState {
+                public:
+                    /**
+                     * Constructor. The seed is drawn from 'std::random_device'.
+                     * @param pSize Pool Size.
+                     */
+                    SteadyState(unsigned int pSize) : SteadyState(pSize, Random::entropy()) {}
+
+                    /**
+                     * Constructor.
+                     * @param pSize Pool Size.
+                     * @param seed Random seed.
+                     */
+                    SteadyState(unsigned int pSize, std::uint64_t seed) : _seed(seed), _count(pSize),
+                        _elite(1), _refresh(pSize / 16 > 0 ? pSize / 16 : 1), _stale(0),
+                        _births(0), _evaluations(0), _insertions(0), _done(false) {
+                        _pool = new C*[pSize];
+                        _score = new double[pSize];
+                    }
+
+                    /**
+                     * Destructor.
+                     */
+                    ~SteadyState() {
+                        delete []_pool;
+                        delete []_score;
+                    }
+
+                    /**
+                     * @return Memo table.
+                     */
+                    H& memo() { return _memo; }
+
+                    /**
+                     * @return Selection policy.
+                     */
+                    S& selection() { return _selection; }
+
+                    /**
+                     * @return Random seed.
+                     */
+                    std::uint64_t seed() const { return _seed; }
+
+                    /**
+                     * @return Number of insertions between two rebuilds of the
+                     * selection tables. At least 1, one 16th of the pool by
+                     * default.
+                     */
+                    unsigned int& refresh() { return _refresh; }
+
+                    /**
+                     * @return Number of offspring bred during the last training.
+                     */
+                    unsigned long long births() const { return _births; }
+
+                    /**
+                     * @return Number of environment evaluations during the last
+                     * training, initial pool included. Memo hits are not counted.
+                     */
+                    unsigned long long evaluations() const { return _evaluations; }
+
+                    /**
+                     * @return Number of offspring that entered the pool during
+                     * the last training.
+                     */
+                    unsigned long long insertions() const { return _insertions; }
+
+                    /**
+                     * Training.
+                     * @param env Environment. See 'Trivial::train'.
+                     * @param maxBirth Maximum number of offspring.
+                     * @param minErr Minimal accepable error.
+                     * @param eliteSize Percentage of the pool, passed to the
+                     *     selection policy (parents of 'Truncation').
+                     * @param store A store for results.
+                     * @param size Size of the storage and maximum number of exit candidate.
+                     * @param mutators Set of operators/mutators. See 'Trivial::train'.
+                     * @return The number of candidates stored in the specified buffer.
+                     */
+                    template <typename E, typename... M> int train(E* env,
+                            unsigned long long maxBirth, double minErr, double eliteSize,
+                            C** store, unsigned int size,
+                            M... mutators) {
+                        _elite = _count * eliteSize;
+                        _elite = _elite < 1 ? 1 : (_elite > _count ? _count : _elite);
+                        _births = 0;
+                        _evaluations = _count;
+                        _insertions = 0;
+                        _stale = 0;
+                        _refresh = _refresh < 1 ? 1 : _refresh;
+                        _done = false;
+
+                        // Initial pool, evaluated and ranked at once.
+                        Random random(_seed, 0, 0, Random::INITIALIZATION);
+                        Concept::reserve(env, _pool, _count, random, 0);
+                        measure(env, Concept::Batch<E, C>());
+                        rank();
+                        _done = _score[0] <= minErr;
+
+                        #pragma omp parallel
+                        {
+                            work(env, maxBirth, minErr, mutators...);
+                        }
+
+                        unsigned int number = _elite < size ? _elite : size;
+                        for(unsigned int i = 0; i < number; ++i) {
+                            store[i] = env->clone(_pool[i]);
+                        }
+
+                        // Clean-up the pool.
+                        env->release(_pool, _count);
+                        _memo.clear(env);
+
+                        return number;
+                    }
+
+                private:
+                    SteadyState(const SteadyState&);
+                    SteadyState& operator=(const SteadyState&);
+
+                    /**
+                     * Evaluate the initial pool one by one.
+                     */
+                    template <typename E> void measure(E* env, std::false_type) {
+                        #pragma omp parallel for
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            Random random(_seed, 0, i, Random::EVALUATION);
+                            _score[i] = Concept::evaluate(env, _pool[i], random, 0);
+                        }
+                    }
+
+                    /**
+                     * Evaluate the initial pool as a batch.
+                     */
+                    template <typename E> void measure(E* env, std::true_type) {
+                        Concept::batch(env, _pool, _count, _score);
+                    }
+
+                    /**
+                     * Sort the initial pool.
+                     */
+                    void rank() {
+                        unsigned int* order = new unsigned int[_count];
+                        C** pool = new C*[_count];
+                        double* score = new double[_count];
+                        Truncation ranking;
+                        ranking.rank(_score, order, _count, _count);
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            pool[i] = _pool[order[i]];
+                            score[i] = _score[order[i]];
+                        }
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            _pool[i] = pool[i];
+                            _score[i] = score[i];
+                        }
+                        delete []score;
+                        delete []pool;
+                        delete []order;
+                        _selection.prepare(_score, _count, _elite);
+                    }
+
+                    /**
+                     * Worker loop.
+                     */
+                    template <typename E, typename... M> void work(E* env,
+                            unsigned long long maxBirth, double minErr, M... mutators) {
+                        // Offspring first, then private parent copies.
+                        C* buffer[1 + GA_MAX_ARITY];
+                        C** parents = buffer + 1;
+                        std::unique_lock<std::mutex> lock(_lock);
+                        {
+                            C** reserved = buffer;
+                            Random random(_seed, 0, _count, Random::INITIALIZATION);
+                            Concept::reserve(env, reserved, 1 + GA_MAX_ARITY, random, 0);
+                        }
+                        C* offspring = buffer[0];
+                        while(!_done && _births < maxBirth) {
+                            unsigned long long birth = _births++;
+                            std::uint32_t high = static_cast<std::uint32_t>(birth >> 32);
+                            std::uint32_t low = static_cast<std::uint32_t>(birth);
+                            Random random(_seed, high + 1, low);
+                            unsigned int index = Cascade().choose(random, mutators...);
+                            unsigned int count = arity(index, mutators...);
+                            count = count > GA_MAX_ARITY ? GA_MAX_ARITY : count;
+                            for(unsigned int i = 0; i < count; ++i) {
+                                Concept::copy(env, _pool[_selection.select(random)], parents[i], 0);
+                            }
+                            lock.unlock();
+                            breed(index, parents, count, offspring, random, mutators...);
+                            lock.lock();
+                            std::size_t hash;
+                            double score;
+                            bool known = _memo.lookup(offspring, hash, score);
+
+                            if(!known) {
+                                lock.unlock();
+                                Random random(_seed, high + 1, low, Random::EVALUATION);
+                                score = Concept::evaluate(env, offspring, random, 0);
+                                lock.lock();
+                                ++_evaluations;
+                                _memo.store(env, offspring, hash, score);
+                            }
+                            offspring = insert(offspring, score);
+                            _done = _done || score <= minErr;
+                        }
+                        buffer[0] = offspring;
+                        env->release(buffer, 1 + GA_MAX_ARITY);
+                    }
+
+                    /**
+                     * @return Arity of the mutator of the specified index.
+                     */
+                    template <typename M> static unsigned int arity(unsigned int, M mutator) {
+                        return Concept::arity(mutator, 0);
+                    }
+
+                    template <typename M, typename... O> static unsigned int arity(unsigned int index,
+                            M mutator, O... others) {
+                        return 0 == index ? Concept::arity(mutator, 0) : arity(index - 1, others...);
+                    }
+
+                    /**
+                     * Apply the mutator of the specified index to private
+                     * parent copies.
+                     */
+                    template <typename M> static void breed(unsigned int, C** parents, unsigned int count,
+                            C* offspring, Random& random, M mutator) {
+                        Changes ignored;
+                        Concept::mutate(mutator, parents, count, offspring, random, ignored, 0);
+                    }
+
+                    template <typename M, typename... O> static void breed(unsigned int index,
+                            C** parents, unsigned int count, C* offspring, Random& random,
+                            M mutator, O... others) {
+                        if(0 == index) {
+                            breed(0, parents, count, offspring, random, mutator);
+                            return;
+                        }
+                        breed(index - 1, parents, count, offspring, random, others...);
+                    }
+
+                    /**
+                     * Insert a candidate in the ranked pool, in place of the
+                     * worst one. Lock must be held.
+                     * @param candidate Candidate.
+                     * @param score Its score.
+                     * @return Candidate that left the pool, i.e. the replaced
+                     * one or the specified one if it's the worst.
+                     */
+                    C* insert(C* candidate, double score) {
+                        unsigned int position = _count - 1;
+                        if(score > _score[position]) {
+                            return candidate;
+                        }
+                        C* worst = _pool[position];
+                        for(; position > 0 && score < _score[position - 1]; --position) {
+                            _pool[position] = _pool[position - 1];
+                            _score[position] = _score[position - 1];
+                        }
+                        _pool[position] = candidate;
+                        _score[position] = score;
+                        ++_insertions;
+                        if(++_stale >= _refresh) {
+                            _selection.prepare(_score, _count, _elite);
+                            _stale = 0;
+                        }
+                        return worst;
+                    }
+
+                private:
+                    /**
+                     * Random seed.
+                     */
+                    std::uint64_t _seed;
+
+                    /**
+                     * Candidate pool, sorted by score.
+                     */
+                    C** _pool;
+
+                    /**
+                     * Pool score.
+                     */
+                    double *_score;
+
+                    /**
+                     * Pool count.
+                     */
+                    unsigned int _count;
+
+                    /**
+                     * Elite count.
+                     */
+                    unsigned int _elite;
+
+                    /**
+                     * Insertions between two selection rebuilds.
+                     */
+                    unsigned int _refresh;
+
+                    /**
+                     * Insertions since the last selection rebuild.
+                     */
+                    unsigned int _stale;
+
+                    /**
+                     * Number of offspring.
+                     */
+                    unsigned long long _births;
+
+                    /**
+                     * Number of evaluations.
+                     */
+                    unsigned long long _evaluations;
+
+                    /**
+                     * Number of insertions.
+                     */
+                    unsigned long long _insertions;
+
+                    /**
+                     * Minimal error reached.
+                     */
+                    bool _done;
+
+                    /**
+                     * Protects everything but the seed and the counts.
+                     */
+                    std::mutex _lock;
+
+                    /**
+                     * Memo table.
+                     */
+                    H _memo;
+
+                    /**
+                     * Selection policy.
+                     */
+                    S _selection;
+            };
+
+        } // Namespace 'GA'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
@@ -0,0 +1,662 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_GENETIC_ALGORITHM_WORKERS
+#define HEADLESS_LOGIC_GENETIC_ALGORITHM_WORKERS
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#error "Out-of-process workers need POSIX (fork, socketpair, poll)."
+#endif
+
+#include "geneticalgorithm.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace GA {
+
+            /**
+             * Out-of-process evaluation (POSIX only, the header does not
+             * compile elsewhere).
+             * Environment adapter that forks worker processes, each one with
+             * its own copy of the wrapped environment, and has them evaluate
+             * candidates. It suits fitness functions that are not thread-safe:
+             * the engines see a thread-safe batch evaluation.
+             *
+             * Candidates are serialized and sent over a local socket to idle
+             * workers; scores are collected as soon as they come, and the
+             * freed worker gets the next candidate. A worker that dies (or
+             * whose socket fails) is restarted and its candidate is sent
+             * again, up to 'retries' times; past that, the candidate gets the
+             * 'failure' score.
+             *
+             * A worker that does not answer within 'timeout' milliseconds is
+             * killed and handled as a dead one. There is no timeout by
+             * default.
+             *
+             * Concurrent calls share the workers: each call takes the idle
+             * ones (waiting for at least one) and gives them back when done.
+             *
+             * Forking a multithreaded process is hazardous (the child may
+             * inherit locks held by other threads, of the allocator for
+             * instance). So the constructor forks a single-threaded fork
+             * server, which forks the workers, initial ones and restarted
+             * ones alike, and hands their sockets over. Workers thus start
+             * from the state of the process at construction, which should
+             * happen before any thread is started. If a fork fails, the
+             * worker stays dead, its candidates failing as dead workers'.
+             *
+             * The destructor closes the sockets, on which end the workers
+             * exit. Those still running after 'timeout' milliseconds (one
+             * second without timeout) are killed.
+             *
+             * Other environment methods ('reserve', 'release', 'clone') are
+             * forwarded to the wrapped environment, in the calling process.
+             * @param <E> Wrapped environment. Workers call its
+             *     'double evaluate(const C*)' and 'reserve' methods.
+             * @param <C> Candidates.
+             * @param <W> Genome serializer, as for checkpoints:
+             *     - void write(std::ostream&, const C*)
+             *     - void read(std::istream&, C*)
+             */
+            template <typename E, typename C, typename W> class Workers {
+                public:
+                    /**
+                     * Constructor. Forks the workers.
+                     * @param env Wrapped environment.
+                     * @param serializer Genome serializer.
+                     * @param count Number of workers.
+                     */
+                    Workers(E* env, W* serializer, unsigned int count) : _env(env),
+                        _serializer(serializer), _count(count), _server(-1), _control(-1),
+                        _idle(count), _retries(1), _failure(std::numeric_limits<double>::infinity()),
+                        _timeout(0), _restarts(0) {
+                        _pid = new pid_t[count];
+                        _socket = new int[count];
+                        _free = new unsigned int[count];
+                        for(unsigned int i = 0; i < count; ++i) {
+                            _pid[i] = -1;
+                            _socket[i] = -1;
+                        }
+                        int ends[2];
+                        if(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, ends)) {
+                            _server = fork();
+                            if(0 == _server) {
+                                close(ends[0]);
+                                server(ends[1]);
+                                _exit(0);
+                            }
+                            close(ends[1]);
+                            if(_server > 0) {
+                                _control = ends[0];
+                            } else {
+                                close(ends[0]);
+                            }
+                        }
+                        for(unsigned int i = 0; i < count; ++i) {
+                            spawn(i);
+                            _free[i] = i;
+                        }
+                    }
+
+                    /**
+                     * Destructor. Workers exit on the end of their socket, or
+                     * are killed after the timeout.
+                     */
+                    ~Workers() {
+                        for(unsigned int i = 0; i < _count; ++i) {
+                            if(_socket[i] >= 0) {
+                                close(_socket[i]);
+                            }
+                        }
+                        if(_control >= 0) {
+                            std::int32_t request[2] = { -1, _timeout > 0 ? _timeout : 1000 };
+                            send(_control, request, sizeof(request));
+                            close(_control);
+                        }
+                        if(_server > 0) {
+                            waitpid(_server, nullptr, 0);
+                        }
+                        delete []_pid;
+                        delete []_socket;
+                        delete []_free;
+                    }
+
+                    /**
+                     * @return Number of workers.
+                     */
+                    unsigned int size() const { return _count; }
+
+                    /**
+                     * @return Number of attempts after a worker failure, for a
+                     * given candidate. 1 by default.
+                     */
+                    unsigned int& retries() { return _retries; }
+
+                    /**
+                     * @return Score of candidates whose attempts all failed.
+                     * Infinite by default.
+                     */
+                    double& failure() { return _failure; }
+
+                    /**
+                     * @return Time given to a worker to evaluate a candidate,
+                     * in milliseconds, after which it is killed. 0, the
+                     * default, means no timeout.
+                     */
+                    int& timeout() { return _timeout; }
+
+                    /**
+                     * @return Number of worker restarts so far.
+                     */
+                    unsigned long long restarts() const { return _restarts.load(); }
+
+                    void reserve(C**& pool, unsigned int count, Random& random) {
+                        Concept::reserve(_env, pool, count, random, 0);
+                    }
+
+                    void release(C** pool, unsigned int count) {
+                        _env->release(pool, count);
+                    }
+
+                    C* clone(const C* candidate) {
+                        return _env->clone(candidate);
+                    }
+
+                    double evaluate(const C* candidate) {
+                        double score;
+                        evaluate(&candidate, 1, &score);
+                        return score;
+                    }
+
+                    void evaluate(const C* const* candidates, unsigned int count, double* scores) {
+                        if(0 == count) {
+                            return;
+                        }
+                        unsigned int* workers = new unsigned int[_count];
+                        unsigned int taken = checkout(workers, count);
+                        dispatch(workers, taken, candidates, count, scores);
+                        checkin(workers, taken);
+                        delete []workers;
+                    }
+
+                private:
+                    Workers(const Workers&);
+                    Workers& operator=(const Workers&);
+
+                    /**
+                     * Have the fork server start a worker, and take its socket.
+                     * The socket stays closed if the fork failed.
+                     * @param index Worker index.
+                     */
+                    void spawn(unsigned int index) {
+                        std::lock_guard<std::mutex> lock(_spawning);
+                        if(_socket[index] >= 0) {
+                            close(_socket[index]);
+                            _socket[index] = -1;
+                        }
+                        std::int32_t request[2] = { static_cast<std::int32_t>(index), 0 };
+                        if(_control >= 0 && send(_control, request, sizeof(request))) {
+                            _socket[index] = take(_control);
+                        }
+                    }
+
+                    /**
+                     * Replace a dead, failed or hung worker.
+                     * @param index Worker index.
+                     */
+                    void respawn(unsigned int index) {
+                        spawn(index);
+                        ++_restarts;
+                    }
+
+                    /**
+                     * Fork server loop. Requests are pairs of integers: a
+                     * worker index to (re)start it, or -1 and a grace period
+                     * to stop. The end of the socket stops it as well, waiting
+                     * for the workers as long as needed.
+                     * Worker processes are only known here, in '_pid'.
+                     * @param control Server end of the control socket.
+                     */
+                    void server(int control) {
+                        std::int32_t request[2] = { -1, -1 };
+                        while(receive(control, request, sizeof(request))) {
+                            if(request[0] < 0 || static_cast<unsigned int>(request[0]) >= _count) {
+                                break;
+                            }
+                            launch(control, request[0]);
+                            request[1] = -1;
+                        }
+                        close(control);
+                        // Let workers exit on the end of their socket, then kill them.
+                        auto deadline = std::chrono::steady_clock::now()
+                            + std::chrono::milliseconds(request[1]);
+                        unsigned int running = _count;
+                        while(running > 0) {
+                            running = 0;
+                            for(unsigned int i = 0; i < _count; ++i) {
+                                if(_pid[i] > 0) {
+                                    if(0 == waitpid(_pid[i], nullptr, WNOHANG)) {
+                                        ++running;
+                                    } else {
+                                        _pid[i] = -1;
+                                    }
+                                }
+                            }
+                            if(running > 0 && request[1] >= 0
+                                    && std::chrono::steady_clock::now() >= deadline) {
+                                for(unsigned int i = 0; i < _count; ++i) {
+                                    if(_pid[i] > 0) {
+                                        kill(_pid[i], SIGKILL);
+                                        waitpid(_pid[i], nullptr, 0);
+                                        _pid[i] = -1;
+                                    }
+                                }
+                                running = 0;
+                            }
+                            if(running > 0) {
+                                usleep(1000);
+                            }
+                        }
+                    }
+
+                    /**
+                     * Kill and reap a worker, if any, then fork it again and
+                     * send its socket (or nothing, if the fork failed) through
+                     * the control socket. Runs in the fork server.
+                     */
+                    void launch(int control, unsigned int index) {
+                        if(_pid[index] > 0) {
+                            kill(_pid[index], SIGKILL);
+                            waitpid(_pid[index], nullptr, 0);
+                            _pid[index] = -1;
+                        }
+                        int ends[2] = { -1, -1 };
+                        pid_t pid = -1;
+                        if(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, ends)) {
+                            pid = fork();
+                            if(0 == pid) {
+                                close(control);
+                                close(ends[0]);
+                                serve(ends[1]);
+                                _exit(0);
+                            }
+                            close(ends[1]);
+                            if(pid < 0) {
+                                close(ends[0]);
+                                ends[0] = -1;
+                            }
+                        }
+                        _pid[index] = pid;
+                        hand(control, ends[0]);
+                        if(ends[0] >= 0) {
+                            close(ends[0]);
+                        }
+                    }
+
+                    /**
+                     * Send a socket (-1 for none) over a Unix socket.
+                     */
+                    static void hand(int control, int socket) {
+                        char flag = socket >= 0 ? 1 : 0;
+                        struct iovec data = { &flag, 1 };
+                        char buffer[CMSG_SPACE(sizeof(int))] = {};
+                        struct msghdr message = {};
+                        message.msg_iov = &data;
+                        message.msg_iovlen = 1;
+                        if(socket >= 0) {
+                            message.msg_control = buffer;
+                            message.msg_controllen = sizeof(buffer);
+                            struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+                            header->cmsg_level = SOL_SOCKET;
+                            header->cmsg_type = SCM_RIGHTS;
+                            header->cmsg_len = CMSG_LEN(sizeof(int));
+                            std::memcpy(CMSG_DATA(header), &socket, sizeof(int));
+                        }
+                        sendmsg(control, &message, MSG_NOSIGNAL);
+                    }
+
+                    /**
+                     * Receive a socket sent by 'hand'.
+                     * @return The socket, -1 if none.
+                     */
+                    static int take(int control) {
+                        char flag = 0;
+                        struct iovec data = { &flag, 1 };
+                        char buffer[CMSG_SPACE(sizeof(int))] = {};
+                        struct msghdr message = {};
+                        message.msg_iov = &data;
+                        message.msg_iovlen = 1;
+                        message.msg_control = buffer;
+                        message.msg_controllen = sizeof(buffer);
+                        if(recvmsg(control, &message, 0) <= 0 || 0 == flag) {
+                            return -1;
+                        }
+                        struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+                        if(nullptr == header || SOL_SOCKET != header->cmsg_level
+                                || SCM_RIGHTS != header->cmsg_type) {
+                            return -1;
+                        }
+                        int socket;
+                        std::memcpy(&socket, CMSG_DATA(header), sizeof(int));
+                        return socket;
+                    }
+
+                    /**
+                     * Worker loop: read a candidate, evaluate it, send its score.
+                     * @param socket Worker end of the socket.
+                     */
+                    void serve(int socket) {
+                        C* candidate;
+                        C** buffer = &candidate;
+                        Random random(0, 0, 0, Random::INITIALIZATION);
+                        Concept::reserve(_env, buffer, 1, random, 0);
+                        std::string payload;
+                        std::uint32_t length;
+                        while(receive(socket, &length, sizeof(length))) {
+                            payload.resize(length);
+                            if(!receive(socket, &payload[0], length)) {
+                                break;
+                            }
+                            std::istringstream in(payload);
+                            _serializer->read(in, candidate);
+                            double score = _env->evaluate(candidate);
+                            if(!send(socket, &score, sizeof(score))) {
+                                break;
+                            }
+                        }
+                        _env->release(buffer, 1);
+                    }
+
+                    /**
+                     * Take idle workers, waiting for at least one.
+                     * @param workers Receives the worker indices.
+                     * @param wanted Maximum number of workers.
+                     * @return Number of workers taken.
+                     */
+                    unsigned int checkout(unsigned int* workers, unsigned int wanted) {
+                        std::unique_lock<std::mutex> lock(_lock);
+                        _available.wait(lock, [this]() { return _idle > 0; });
+                        unsigned int taken = 0;
+                        while(_idle > 0 && taken < wanted) {
+                            workers[taken++] = _free[--_idle];
+                        }
+                        return taken;
+                    }
+
+                    /**
+                     * Give workers back.
+                     */
+                    void checkin(const unsigned int* workers, unsigned int count) {
+                        {
+                            std::lock_guard<std::mutex> lock(_lock);
+                            for(unsigned int i = 0; i < count; ++i) {
+                                _free[_idle++] = workers[i];
+                            }
+                        }
+                        _available.notify_all();
+                    }
+
+                    /**
+                     * Evaluate candidates with the specified workers.
+                     */
+                    void dispatch(const unsigned int* workers, unsigned int taken,
+                            const C* const* candidates, unsigned int count, double* scores) {
+                        typedef std::chrono::steady_clock Clock;
+                        // Candidate handled by each worker, 'count' if none.
+                        unsigned int* current = new unsigned int[taken];
+                        // When each worker must have answered.
+                        Clock::time_point* deadline = new Clock::time_point[taken];
+                        unsigned int* attempts = new unsigned int[count];
+                        struct pollfd* polls = new struct pollfd[taken];
+                        for(unsigned int i = 0; i < count; ++i) {
+                            attempts[i] = 0;
+                        }
+                        std::chrono::milliseconds timeout(_timeout);
+                        unsigned int next = 0;
+                        unsigned int done = 0;
+                        for(unsigned int w = 0; w < taken; ++w) {
+                            current[w] = count;
+                            feed(workers[w], current[w], next, done, candidates, count, scores, attempts);
+                            deadline[w] = Clock::now() + timeout;
+                        }
+                        while(done < count) {
+                            unsigned int busy = 0;
+                            Clock::time_point first = Clock::time_point::max();
+                            for(unsigned int w = 0; w < taken; ++w) {
+                                if(current[w] < count) {
+                                    polls[busy].fd = _socket[workers[w]];
+                                    polls[busy].events = POLLIN;
+                                    polls[busy].revents = 0;
+                                    ++busy;
+                                    first = std::min(first, deadline[w]);
+                                }
+                            }
+                            int wait = -1;
+                            if(_timeout > 0) {
+                                wait = std::max<long long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            first - Clock::now()).count() + 1);
+                            }
+                            if(poll(polls, busy, wait) < 0) {
+                                continue;
+                            }
+                            Clock::time_point now = Clock::now();
+                            for(unsigned int w = 0, p = 0; w < taken; ++w) {
+                                if(current[w] >= count) {
+                                    continue;
+                                }
+                                bool ready = 0 != polls[p++].revents;
+                                bool late = _timeout > 0 && now >= deadline[w];
+                                if(!ready && !late) {
+                                    continue;
+                                }
+                                unsigned int index = current[w];
+                                if(ready && receive(_socket[workers[w]], scores + index, sizeof(double))) {
+                                    ++done;
+                                    current[w] = count;
+                                } else {
+                                    // Crashed or hung: try again with a new worker.
+                                    respawn(workers[w]);
+                                    current[w] = count;
+                                    if(!post(workers[w], index, candidates, scores, attempts)) {
+                                        ++done;
+                                    } else {
+                                        current[w] = index;
+                                    }
+                                }
+                                if(current[w] >= count) {
+                                    feed(workers[w], current[w], next, done, candidates, count, scores,
+                                            attempts);
+                                }
+                                deadline[w] = Clock::now() + timeout;
+                            }
+                        }
+                        delete []polls;
+                        delete []attempts;
+                        delete []deadline;
+                        delete []current;
+                    }
+
+                    /**
+                     * Give the next candidate, if any, to an idle worker.
+                     * Candidates that fail are skipped.
+                     */
+                    void feed(unsigned int worker, unsigned int& current, unsigned int& next,
+                            unsigned int& done, const C* const* candidates, unsigned int count,
+                            double* scores, unsigned int* attempts) {
+                        while(next < count) {
+                            unsigned int index = next++;
+                            if(post(worker, index, candidates, scores, attempts)) {
+                                current = index;
+                                return;
+                            }
+                            ++done;
+                        }
+                    }
+
+                    /**
+                     * Send a candidate to a worker, restarting it on failure.
+                     * @return 'false' if attempts are exhausted, the candidate
+                     * having then the failure score.
+                     */
+                    bool post(unsigned int worker, unsigned int index, const C* const* candidates,
+                            double* scores, unsigned int* attempts) {
+                        std::ostringstream out;
+                        _serializer->write(out, candidates[index]);
+                        std::string payload = out.str();
+                        std::uint32_t length = payload.size();
+                        while(attempts[index]++ <= _retries) {
+                            if(send(_socket[worker], &length, sizeof(length))
+                                    && send(_socket[worker], payload.data(), length)) {
+                                return true;
+                            }
+                            respawn(worker);
+                        }
+                        scores[index] = _failure;
+                        return false;
+                    }
+
+                    /**
+                     * Write a whole buffer, without raising SIGPIPE.
+                     */
+                    static bool send(int socket, const void* data, std::size_t size) {
+                        const char* bytes = static_cast<const char*>(data);
+                        while(size > 0) {
+                            ssize_t written = ::send(socket, bytes, size, MSG_NOSIGNAL);
+                            if(written <= 0) {
+                                return false;
+                            }
+                            bytes += written;
+                            size -= written;
+                        }
+                        return true;
+                    }
+
+                    /**
+                     * Read a whole buffer.
+                     * @return 'false' on end of stream or error.
+                     */
+                    static bool receive(int socket, void* data, std::size_t size) {
+                        char* bytes = static_cast<char*>(data);
+                        while(size > 0) {
+                            ssize_t received = ::recv(socket, bytes, size, 0);
+                            if(received <= 0) {
+                                return false;
+                            }
+                            bytes += received;
+                            size -= received;
+                        }
+                        return true;
+                    }
+
+                private:
+                    /**
+                     * Wrapped environment.
+                     */
+                    E* _env;
+
+                    /**
+                     * Genome serializer.
+                     */
+                    W* _serializer;
+
+                    /**
+                     * Number of workers.
+                     */
+                    unsigned int _count;
+
+                    /**
+                     * Worker processes. Only maintained by the fork server.
+                     */
+                    pid_t* _pid;
+
+                    /**
+                     * Fork server process.
+                     */
+                    pid_t _server;
+
+                    /**
+                     * Main end of the fork server socket.
+                     */
+                    int _control;
+
+                    /**
+                     * Parent end of the worker sockets.
+                     */
+                    int* _socket;
+
+                    /**
+                     * Idle workers, as a stack.
+                     */
+                    unsigned int* _free;
+
+                    /**
+                     * Number of idle workers.
+                     */
+                    unsigned int _idle;
+
+                    /**
+                     * Attempts after a failure.
+                     */
+                    unsigned int _retries;
+
+                    /**
+                     * Score of failed candidates.
+                     */
+                    double _failure;
+
+                    /**
+                     * Evaluation timeout, in milliseconds.
+                     */
+                    int _timeout;
+
+                    /**
+                     * Number of restarts.
+                     */
+                    std::atomic<unsigned long long> _restarts;
+
+                    /**
+                     * Protects the idle workers.
+                     */
+                    std::mutex _lock;
+
+                    /**
+                     * Signals idle workers.
+                     */
+                    std::condition_variable _available;
+
+                    /**
+                     * Serializes fork server requests.
+                     */
+                    std::mutex _spawning;
+            };
+
+        } // Namespace 'GA'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
@@ -16,12 +16,172 @@
 #ifndef HEADLESS_LOGIC_SEARCH_TREE
 #define HEADLESS_LOGIC_SEARCH_TREE
 
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <vector>
+
 #define DEFAULT_CARD 16
 #define VISIT_BUFFER_SIZE 32
+#define STATISTICS_MAX_DEPTH 64
 namespace Headless {
     namespace Logic {
         namespace SearchTree {
 
+            /**
+             * Null statistics policy.
+             * Every hook is an empty inline method and the policy has no state.
+             * As the node privately inherits from its policy, a tree using this
+             * one pays neither time nor memory.
+             */
+            class NoStatistics {
+                public:
+                    /** A root node is created. */
+                    void open() {}
+                    /** A sub-node is created. */
+                    void inherit(const NoStatistics&) {}
+                    /** A root node is destroyed. */
+                    void close() {}
+                    /** A query enters a node. */
+                    void enter() const {}
+                    /** A query tests a node region. */
+                    void region() const {}
+                    /** A query tests an element key. */
+                    void key() const {}
+                    /** A query returns elements. */
+                    void elements(unsigned int) const {}
+                    /** A leaf is split. */
+                    void split() {}
+                    /** A node is collapsed into a leaf. */
+                    void collapse() {}
+                    /** Memory is allocated. */
+                    void allocate(std::size_t) {}
+            };
+
+            /**
+             * Counting statistics policy.
+             * All the nodes of a tree share the counters owned by the root.
+             * Counters are relaxed atomics, so concurrent queries on the same
+             * tree count exactly (at the cost of an atomic increment per hook).
+             */
+            class Statistics {
+                public:
+                    /**
+                     * Shared counters.
+                     */
+                    struct Counters {
+                        /** Nodes entered by queries. */
+                        unsigned long long entered;
+                        /** Regions tested by queries. */
+                        unsigned long long regions;
+                        /** Keys tested by queries. */
+                        unsigned long long keys;
+                        /** Elements returned by queries. */
+                        unsigned long long elements;
+                        /** Leaf splits. */
+                        unsigned long long splits;
+                        /** Node collapses. */
+                        unsigned long long collapses;
+                        /** Allocations. */
+                        unsigned long long allocations;
+                        /** Allocated bytes. */
+                        unsigned long long bytes;
+                    };
+                public:
+                    Statistics() : _counters(nullptr) {}
+                    /**
+                     * @return A snapshot of the current counters.
+                     */
+                    Counters counters() const {
+                        Counters counters;
+                        counters.entered = load(_counters->entered);
+                        counters.regions = load(_counters->regions);
+                        counters.keys = load(_counters->keys);
+                        counters.elements = load(_counters->elements);
+                        counters.splits = load(_counters->splits);
+                        counters.collapses = load(_counters->collapses);
+                        counters.allocations = load(_counters->allocations);
+                        counters.bytes = load(_counters->bytes);
+                        return counters;
+                    }
+                    /**
+                     * Reset all counters.
+                     */
+                    void reset() {
+                        Counter* counters[] = { &_counters->entered, &_counters->regions,
+                            &_counters->keys, &_counters->elements, &_counters->splits,
+                            &_counters->collapses, &_counters->allocations, &_counters->bytes };
+                        for(Counter* counter : counters) {
+                            counter->store(0, std::memory_order_relaxed);
+                        }
+                    }
+
+                    void open() { _counters = new Shared(); }
+                    void inherit(const Statistics& parent) { _counters = parent._counters; }
+                    void close() { delete _counters; }
+                    void enter() const { add(_counters->entered, 1); }
+                    void region() const { add(_counters->regions, 1); }
+                    void key() const { add(_counters->keys, 1); }
+                    void elements(unsigned int count) const { add(_counters->elements, count); }
+                    void split() { add(_counters->splits, 1); }
+                    void collapse() { add(_counters->collapses, 1); }
+                    void allocate(std::size_t bytes) {
+                        add(_counters->allocations, 1);
+                        add(_counters->bytes, bytes);
+                    }
+                private:
+                    typedef std::atomic<unsigned long long> Counter;
+
+                    /**
+                     * Counters as shared by the nodes.
+                     */
+                    struct Shared {
+                        Shared() : entered(0), regions(0), keys(0), elements(0),
+                            splits(0), collapses(0), allocations(0), bytes(0) {}
+                        Counter entered;
+                        Counter regions;
+                        Counter keys;
+                        Counter elements;
+                        Counter splits;
+                        Counter collapses;
+                        Counter allocations;
+                        Counter bytes;
+                    };
+
+                    static void add(Counter& counter, unsigned long long value) {
+                        counter.fetch_add(value, std::memory_order_relaxed);
+                    }
+
+                    static unsigned long long load(const Counter& counter) {
+                        return counter.load(std::memory_order_relaxed);
+                    }
+                private:
+                    Shared* _counters;
+            };
+
+            /**
+             * Tree structure report.
+             * Unlike statistics, it is computed on demand by walking the tree.
+             */
+            struct Structure {
+                /** Depth of the tree (1 for a single leaf). */
+                unsigned int       depth;
+                /** Number of leaves per depth (0 being the root). */
+                unsigned int       leaves[STATISTICS_MAX_DEPTH];
+                /** Number of live nodes, leaves included. */
+                unsigned int       nodes;
+                /** Number of live leaves. */
+                unsigned int       leafCount;
+                /** Number of live leaves without elements. */
+                unsigned int       emptyLeaves;
+                /** Number of elements. */
+                unsigned long long elements;
+                /** Average leaf fill factor, in [0, 1]. */
+                double             fill;
+                /** Bytes used by the tree, recycled nodes included. */
+                unsigned long long bytes;
+            };
+
             /**
              * Search Tree Node.
              *
@@ -45,8 +205,10 @@ namespace Headless {
              *         const K& key() const;
              *     Set the key.
              *         void key(const K&);
+             * @param <P> Statistics policy. 'NoStatistics' or 'Statistics'.
              */
-            template <typename K, typename R, typename E> class Node {
+            template <typename K, typename R, typename E, typename P = NoStatistics>
+                class Node : private P {
                 public:
                     class Visitor {
                         public:
@@ -75,6 +237,16 @@ namespace Headless {
                      * @param element Pointer to the element to add.
                      */
                     void add(E* element);
+                    /**
+                     * Bulk insertion.
+                     * Elements are distributed top-down, splitting each node at
+                     * most once, which is much cheaper than repeated calls
+                     * to 'add'. The node is expected to be empty.
+                     * Elements out of the node region are ignored.
+                     * @param elements Elements to add. The array is re-ordered.
+                     * @param count Number of elements.
+                     */
+                    void build(E** elements, unsigned int count);
                     /**
                      * Remove an element.
                      * @param element Pointer to the element instance to remove.
@@ -103,6 +275,48 @@ namespace Headless {
                      */
                     template <typename S, typename V = Visitor> unsigned int retrieve(const S& func,
                             E** buffer, unsigned int size, V* visitor = nullptr) const;
+                    /**
+                     * Sampling candidate: a leaf to be tested or a fully
+                     * contained sub-tree. Only meant as 'sample' storage.
+                     */
+                    struct Candidate {
+                        const Node*        node;
+                        bool               full;
+                        unsigned long long bound;
+                    };
+                    /**
+                     * Draw random elements within a search function.
+                     * Sub-trees fully contained by the search function are drawn
+                     * from proportionally to their population, without inspecting
+                     * them. Elements of partially covered leaves are drawn the same
+                     * way and rejected if out of the search function, so that
+                     * the drawing is uniform among eligible elements.
+                     * Drawing is done with replacement: an element can be returned
+                     * more than once.
+                     * @param <S> Search function type (see 'retrieve').
+                     * @param <G> Uniform random bit generator (e.g. std::mt19937).
+                     * @param func Search function.
+                     * @param buffer Storage for drawn elements.
+                     * @param count Number of elements to draw.
+                     * @param generator Random generator.
+                     * @return Number of drawn elements. Less than 'count' if there
+                     * is no eligible element or if rejections keep failing.
+                     */
+                    template <typename S, typename G> unsigned int sample(const S& func,
+                            E** buffer, unsigned int count, G& generator) const;
+                    /**
+                     * Same as above, with a caller-provided storage for the
+                     * sampling candidates, so that repeated calls do not
+                     * allocate.
+                     * @param candidates Candidate storage, cleared by the call.
+                     */
+                    template <typename S, typename G> unsigned int sample(const S& func,
+                            E** buffer, unsigned int count, G& generator,
+                            std::vector<Candidate>& candidates) const;
+                    /**
+                     * @return Number of elements in the tree.
+                     */
+                    unsigned int size() const { return _population; }
                     /**
                      * Recursive visit of the tree.
                      * @param <V> Visitor concept.
@@ -111,10 +325,17 @@ namespace Headless {
                      * @param visitor Visitor.
                      */
                     template <typename V> void visit(V& visitor);
-
-#ifdef TREE_DEBUG
-                    template <typename V> void deepVisit(V &visitor);
-#endif
+                    /**
+                     * Compute the structure report of the tree.
+                     * @param report Report to be filled.
+                     */
+                    void report(Structure& report) const;
+                    /**
+                     * Access the statistics policy.
+                     * @return Policy shared by the whole tree.
+                     */
+                    const P& statistics() const { return *this; }
+                    P& statistics() { return *this; }
 
                 private:
                     /**
@@ -127,12 +348,36 @@ namespace Headless {
                      */
                     template <typename V = Visitor> unsigned int fetch(E** buffer,
                             unsigned int size, V* visitor = nullptr) const;
+                    /**
+                     * Collect sampling candidates.
+                     * @param func Search function.
+                     * @param candidates Candidates. Bounds are cumulated populations.
+                     */
+                    template <typename S> void candidates(const S& func,
+                            std::vector<Candidate>& candidates) const;
                     /**
                      * Find the leaf that can possibly host the key.
                      * @param key Node key to locate.
                      * @return A leaf or nullptr if the key is outside the master region.
                      */
                     Node* find(const K& key);
+                    /**
+                     * Distribute elements among this (empty) node and its sub-nodes.
+                     * @param elements Elements contained in the node region.
+                     * @param count Number of elements.
+                     */
+                    void distribute(E** elements, unsigned int count);
+                    /**
+                     * Recursive part of 'report'.
+                     * @param report Report to be filled.
+                     * @param depth Depth of this node.
+                     * @param live 'false' for recycled nodes.
+                     */
+                    void report(Structure& report, unsigned int depth, bool live) const;
+                    /**
+                     * Allocate sub-nodes.
+                     */
+                    void divide();
                 private:
                     /** Region of interest. */
                     const R*                 _region;
@@ -142,22 +387,30 @@ namespace Headless {
                     unsigned int             _count;
                     /** Maximum number of elements. */
                     unsigned int             _cardinality;
+                    /** Number of elements in the sub-tree. */
+                    unsigned int             _population;
                     /** Sub-node. 'null' if leaf. */
-                    Node<K, R, E>**          _nodes;
+                    Node<K, R, E, P>**          _nodes;
                     /** Parent node. */
-                    Node<K, R, E>*           _parent;
+                    Node<K, R, E, P>*           _parent;
                     /** Leaf indicator. Indirect recycling info. */
                     bool                     _leaf;
             };
 
-            template <typename K, typename R, typename E>
-                Node<K, R, E>::Node(const R* region, unsigned int card, Node<K, R, E>* parent) :
+            template <typename K, typename R, typename E, typename P>
+                Node<K, R, E, P>::Node(const R* region, unsigned int card, Node<K, R, E, P>* parent) :
                     _region(region), _elements(new E*[card]), _count(0),
-                    _cardinality(card), _nodes(nullptr), _parent(parent), _leaf(true) {
+                    _cardinality(card), _population(0), _nodes(nullptr), _parent(parent), _leaf(true) {
+                        if(nullptr == parent) {
+                            P::open();
+                        } else {
+                            P::inherit(*parent);
+                        }
+                        P::allocate(sizeof(Node<K, R, E, P>) + card * sizeof(E*));
                     }
 
-            template <typename K, typename R, typename E>
-                Node<K, R, E>::~Node() {
+            template <typename K, typename R, typename E, typename P>
+                Node<K, R, E, P>::~Node() {
                     delete []_elements;
                     if(_nodes != nullptr) {
                         unsigned int dimension = _region->dimension();
@@ -168,37 +421,36 @@ namespace Headless {
                         delete []region;
                         delete []_nodes;
                     }
+                    if(nullptr == _parent) {
+                        P::close();
+                    }
                 }
 
-            template <typename K, typename R, typename E>
-                Node<K, R, E>* Node<K, R, E>::find(const K& key) {
-                    Node<K, R, E>* result;
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::divide() {
+                    unsigned int dimension = _region->dimension();
+                    _nodes = new Node<K, R, E, P>*[dimension];
+                    const R* regions = _region->divide();
+                    P::allocate(dimension * (sizeof(Node<K, R, E, P>*) + sizeof(R)));
+                    for(unsigned int i = 0; i < dimension; ++i) {
+                        _nodes[i] = new Node<K, R, E, P>(regions + i, _cardinality, this);
+                    }
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                Node<K, R, E, P>* Node<K, R, E, P>::find(const K& key) {
+                    Node<K, R, E, P>* result;
                     if(_region->contains(key)) {
                         result = this;
-                        Node<K, R, E>** nodes;
-#ifdef TREE_DEBUG
-                        bool loop;
-#endif
+                        Node<K, R, E, P>** nodes;
                         while(!result->_leaf) {
                             nodes = result->_nodes;
-#ifdef TREE_DEBUG
-                            loop = true;
-#endif
                             for(unsigned int i = 0; i < result->_count; ++i) {
                                 if(nodes[i]->_region->contains(key)) {
                                     result = nodes[i];
-#ifdef TREE_DEBUG
-                                    loop = false;
-#endif
                                     break;
                                 }
                             }
-#ifdef TREE_DEBUG
-                            if(loop) {
-                                result = nullptr;
-                                break;
-                            }
-#endif
                         }
                     } else {
                         result = nullptr;
@@ -206,24 +458,21 @@ namespace Headless {
                     return result;
                 }
 
-            template <typename K, typename R, typename E>
-                void Node<K, R, E>::add(E* element) {
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::add(E* element) {
                     const K& key = element->key();
-                    Node<K, R, E>* node = find(key);
+                    Node<K, R, E, P>* node = find(key);
                     if(nullptr != node) {
                         while(_cardinality == node->_count) {
+                            P::split();
                             node->_leaf = false;
                             unsigned int dimension = node->_region->dimension();
                             if(nullptr == node->_nodes) {
-                                node->_nodes = new Node<K, R, E>*[dimension];
-                                const R* regions = node->_region->divide();
-                                for(unsigned int i = 0; i < dimension; ++i) {
-                                    node->_nodes[i] = new Node<K, R, E>(regions + i, _cardinality, node);
-                                }
+                                node->divide();
                             }
                             E** toShare = node->_elements;
                             unsigned int shareCount = node->_count;
-                            Node<K, R, E>* target;
+                            Node<K, R, E, P>* target;
                             for(unsigned int i = 0; i < dimension; ++i) {
                                 target = node->_nodes[i];
                                 target->_count = 0;
@@ -237,6 +486,7 @@ namespace Headless {
                                         ++j;
                                     }
                                 }
+                                target->_population = target->_count;
                             }
                             node->_count = dimension;
                             for(unsigned int i = 0; i < dimension; ++i) {
@@ -249,13 +499,71 @@ namespace Headless {
                         }
                         node->_elements[node->_count] = element;
                         ++node->_count;
+                        for(; nullptr != node; node = node->_parent) {
+                            ++node->_population;
+                        }
+                    }
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::build(E** elements, unsigned int count) {
+                    unsigned int contained = 0;
+                    for(unsigned int i = 0; i < count; ++i) {
+                        if(_region->contains(elements[i]->key())) {
+                            E* element = elements[i];
+                            elements[i] = elements[contained];
+                            elements[contained] = element;
+                            ++contained;
+                        }
                     }
+                    distribute(elements, contained);
                 }
 
-            template <typename K, typename R, typename E>
-                void Node<K, R, E>::remove(E* element) {
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::distribute(E** elements, unsigned int count) {
+                    _population = count;
+                    if(count <= _cardinality) {
+                        for(unsigned int i = 0; i < count; ++i) {
+                            _elements[i] = elements[i];
+                        }
+                        _count = count;
+                    } else {
+                        P::split();
+                        _leaf = false;
+                        unsigned int dimension = _region->dimension();
+                        if(nullptr == _nodes) {
+                            divide();
+                        }
+                        // Same policy as 'add': an element goes to the first
+                        // sub-node containing it.
+                        E** toShare = elements;
+                        unsigned int remaining = count;
+                        Node<K, R, E, P>* target;
+                        for(unsigned int i = 0; i < dimension; ++i) {
+                            target = _nodes[i];
+                            target->_leaf = true;
+                            target->_count = 0;
+                            unsigned int shared = 0;
+                            for(unsigned int j = 0; j < remaining; ++j) {
+                                if(target->_region->contains(toShare[j]->key())) {
+                                    E* element = toShare[j];
+                                    toShare[j] = toShare[shared];
+                                    toShare[shared] = element;
+                                    ++shared;
+                                }
+                            }
+                            target->distribute(toShare, shared);
+                            toShare += shared;
+                            remaining -= shared;
+                        }
+                        _count = dimension;
+                    }
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::remove(E* element) {
                     const K& key = element->key();
-                    Node<K, R, E>* node = find(key);
+                    Node<K, R, E, P>* node = find(key);
                     if(nullptr != node) {
                         unsigned int count = node->_count;
                         E** elements = node->_elements;
@@ -263,6 +571,10 @@ namespace Headless {
                             if(element == (*elements)) {
                                 --node->_count;
                                 *elements = node->_elements[node->_count];
+                                for(Node<K, R, E, P>* ancestor = node; nullptr != ancestor;
+                                        ancestor = ancestor->_parent) {
+                                    --ancestor->_population;
+                                }
                                 break;
                             }
                         }
@@ -279,10 +591,11 @@ namespace Headless {
                                 }
                             }
                             if(global <= _cardinality) {
+                                P::collapse();
                                 node->_leaf = true;
                                 node->_count = 0;
                                 for(unsigned int i = 0; i < count; ++i) {
-                                    Node<K, R, E>* target = node->_nodes[i];
+                                    Node<K, R, E, P>* target = node->_nodes[i];
                                     unsigned int toRetrieve = target->_count;
                                     for(unsigned int j = 0; j < toRetrieve; ++j) {
                                         node->_elements[node->_count] = target->_elements[j];
@@ -296,22 +609,25 @@ namespace Headless {
                     }
                 }
 
-            template <typename K, typename R, typename E>
-                void Node<K, R, E>::move(E* element, K& key) {
-                    const K& elementKey = element->key();
-                    element->key(key);
-                    Node<K, R, E>* sourceNode = find(elementKey);
-                    Node<K, R, E>* destinationNode = find(key);
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::move(E* element, K& key) {
+                    // Locate the source before the key changes.
+                    Node<K, R, E, P>* sourceNode = find(element->key());
+                    Node<K, R, E, P>* destinationNode = find(key);
                     if(destinationNode != sourceNode) {
-                        destinationNode->add(element);
-                        sourceNode->remove(element);
+                        remove(element);
+                        element->key(key);
+                        add(element);
+                    } else {
+                        element->key(key);
                     }
                 }
 
-            template <typename K, typename R, typename E>
+            template <typename K, typename R, typename E, typename P>
                 template <typename S, typename V>
-                unsigned int Node<K, R, E>::retrieve(const S& func, E** buffer, unsigned int size, V* visitor) const {
+                unsigned int Node<K, R, E, P>::retrieve(const S& func, E** buffer, unsigned int size, V* visitor) const {
                     unsigned int result;
+                    P::enter();
                     if(nullptr != visitor) {
                         visitor->enter(*_region);
                     }
@@ -326,6 +642,7 @@ namespace Headless {
                         E** cur = _elements;
                         result = 0;
                         for(unsigned int i = 0; i < max; ++i, ++cur) {
+                            P::key();
                             if(func.contains((*cur)->key())) {
                                 if(nullptr != visitor) {
                                     visitor->inspect(*cur);
@@ -335,6 +652,7 @@ namespace Headless {
                                 ++result;
                             }
                         }
+                        P::elements(result);
                     } else {
                         // We're in a node.
                         // Let's test all the subs against the 'func'. In some cases,
@@ -343,8 +661,9 @@ namespace Headless {
                         unsigned int remaining = size;
                         unsigned int retrieved;
                         int intersects;
-                        Node<K, R, E>** nodes = _nodes;
+                        Node<K, R, E, P>** nodes = _nodes;
                         for(unsigned int i = 0; i < _count; ++i, ++nodes) {
+                            P::region();
                             intersects = func.contains(*((*nodes)->_region));
                             if(intersects >= 0) {
                                 if(intersects != 0) {
@@ -364,9 +683,110 @@ namespace Headless {
                     return result;
                 }
 
-            template <typename K, typename R, typename E>
+            template <typename K, typename R, typename E, typename P>
+                template <typename S, typename G>
+                unsigned int Node<K, R, E, P>::sample(const S& func, E** buffer,
+                        unsigned int count, G& generator) const {
+                    std::vector<Candidate> candidates;
+                    return sample(func, buffer, count, generator, candidates);
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                template <typename S, typename G>
+                unsigned int Node<K, R, E, P>::sample(const S& func, E** buffer,
+                        unsigned int count, G& generator, std::vector<Candidate>& candidates) const {
+                    candidates.clear();
+                    this->candidates(func, candidates);
+                    if(candidates.empty() || 0 == count) {
+                        return 0;
+                    }
+                    std::uniform_int_distribution<unsigned long long> dist(0, candidates.back().bound - 1);
+                    // Rejections only happen in partially covered leaves.
+                    // Bound the attempts in case none of their elements is eligible.
+                    unsigned long long attempts = 64ULL * count;
+                    unsigned int result = 0;
+                    while(result < count && attempts > 0) {
+                        --attempts;
+                        unsigned long long draw = dist(generator);
+                        unsigned int lo = 0;
+                        unsigned int hi = candidates.size() - 1;
+                        while(lo < hi) {
+                            unsigned int mid = (lo + hi) / 2;
+                            if(draw < candidates[mid].bound) {
+                                hi = mid;
+                            } else {
+                                lo = mid + 1;
+                            }
+                        }
+                        const Candidate& candidate = candidates[lo];
+                        unsigned long long index = draw - (lo > 0 ? candidates[lo - 1].bound : 0);
+                        const Node<K, R, E, P>* node = candidate.node;
+                        // Descend using the draw itself as an index in the sub-tree.
+                        // Populations are expected to add up; if they do not,
+                        // the draw is rejected rather than followed astray.
+                        const Node<K, R, E, P>* parent = nullptr;
+                        while(!node->_leaf && node != parent) {
+                            P::enter();
+                            parent = node;
+                            Node<K, R, E, P>** nodes = node->_nodes;
+                            for(unsigned int i = 0; i < node->_count; ++i) {
+                                if(index < nodes[i]->_population) {
+                                    node = nodes[i];
+                                    break;
+                                }
+                                index -= nodes[i]->_population;
+                            }
+                        }
+                        if(!node->_leaf || index >= node->_count) {
+                            continue;
+                        }
+                        E* element = node->_elements[index];
+                        if(!candidate.full) {
+                            P::key();
+                            if(!func.contains(element->key())) {
+                                continue;
+                            }
+                        }
+                        buffer[result] = element;
+                        ++result;
+                    }
+                    P::elements(result);
+                    return result;
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                template <typename S>
+                void Node<K, R, E, P>::candidates(const S& func, std::vector<Candidate>& candidates) const {
+                    P::enter();
+                    unsigned long long bound = candidates.empty() ? 0 : candidates.back().bound;
+                    if(_leaf) {
+                        // As for 'retrieve', a leaf reached here must be tested.
+                        if(_count > 0) {
+                            Candidate candidate = { this, false, bound + _count };
+                            candidates.push_back(candidate);
+                        }
+                    } else {
+                        Node<K, R, E, P>** nodes = _nodes;
+                        for(unsigned int i = 0; i < _count; ++i, ++nodes) {
+                            P::region();
+                            int intersects = func.contains(*((*nodes)->_region));
+                            if(intersects > 0) {
+                                if((*nodes)->_population > 0) {
+                                    bound = candidates.empty() ? 0 : candidates.back().bound;
+                                    Candidate candidate = { *nodes, true, bound + (*nodes)->_population };
+                                    candidates.push_back(candidate);
+                                }
+                            } else if(intersects == 0) {
+                                (*nodes)->candidates(func, candidates);
+                            }
+                        }
+                    }
+                }
+
+            template <typename K, typename R, typename E, typename P>
                 template <typename V>
-                unsigned int Node<K, R, E>::fetch(E** buffer, unsigned int size, V* visitor) const {
+                unsigned int Node<K, R, E, P>::fetch(E** buffer, unsigned int size, V* visitor) const {
+                    P::enter();
                     if(nullptr != visitor) {
                         visitor->enter(*_region);
                     }
@@ -382,6 +802,7 @@ namespace Headless {
                         for(unsigned int i = 0; i < result; ++i, ++dest, ++src) {
                             *dest = *src;
                         }
+                        P::elements(result);
                     } else {
                         result = 0;
                         E** dest = buffer;
@@ -400,9 +821,9 @@ namespace Headless {
                     return result;
                 }
 
-            template <typename K, typename R, typename E>
+            template <typename K, typename R, typename E, typename P>
                 template <typename V>
-                void Node<K, R, E>::visit(V &visitor) {
+                void Node<K, R, E, P>::visit(V &visitor) {
                     visitor.enter(*_region);
                     if(_leaf) {
                         visitor.inspect(_elements, _count);
@@ -414,19 +835,44 @@ namespace Headless {
                     visitor.exit(*_region);
                 }
 
-#ifdef TREE_DEBUG
-            template <typename K, typename R, typename E>
-                template <typename V>
-                void Node<K, R, E>::deepVisit(V &visitor) {
-                    visitor.visit(this, _region, _elements, _nodes, _parent, _leaf, _count, _cardinality);
-                    if(_nodes) {
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::report(Structure& report) const {
+                    report = Structure();
+                    this->report(report, 0, true);
+                    if(report.leafCount > 0) {
+                        report.fill = static_cast<double>(report.elements) /
+                            (static_cast<double>(report.leafCount) * _cardinality);
+                    }
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                void Node<K, R, E, P>::report(Structure& report, unsigned int depth, bool live) const {
+                    report.bytes += sizeof(Node<K, R, E, P>) + _cardinality * sizeof(E*);
+                    if(live) {
+                        ++report.nodes;
+                        if(depth >= report.depth) {
+                            report.depth = depth + 1;
+                        }
+                        if(_leaf) {
+                            ++report.leafCount;
+                            report.elements += _count;
+                            if(0 == _count) {
+                                ++report.emptyLeaves;
+                            }
+                            if(depth < STATISTICS_MAX_DEPTH) {
+                                ++report.leaves[depth];
+                            }
+                        }
+                    }
+                    if(nullptr != _nodes) {
+                        // Sub-nodes of a collapsed node are kept for recycling.
                         unsigned int dimension = _region->dimension();
+                        report.bytes += dimension * (sizeof(Node<K, R, E, P>*) + sizeof(R));
                         for(unsigned int i = 0; i < dimension; ++i) {
-                            _nodes[i]->deepVisit(visitor);
+                            _nodes[i]->report(report, depth + 1, live && !_leaf);
                         }
                     }
                 }
-#endif
 
         } // Namespace 'SearchTree'
     } // Namespace 'Logic'
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_SEARCH_TREE_BUFFER
+#define HEADLESS_LOGIC_SEARCH_TREE_BUFFER
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "searchtree.hpp"
+
+namespace Headless {
+    namespace Logic {
+        namespace SearchTree {
+
+            /**
+             * Double-buffered Search Tree.
+             *
+             * Readers query the current tree while the next one is bulk-built
+             * on a background thread. The builder lives as long as the buffer
+             * and sleeps between builds, so that a tick does not pay for a
+             * thread start. Once built, the new tree is published
+             * atomically. The previous tree stays alive as long as a reader holds
+             * it and its destruction is deferred to the next background build,
+             * so that neither the build nor the release is paid by the caller.
+             *
+             * Typical usage, once per tick:
+             *     buffer.rebuild(pool, count); // Keys must not change until 'swap'.
+             *     ... // Queries on 'buffer.current()'.
+             *     buffer.swap();
+             *
+             * @param <K> Key concept (see 'Node').
+             * @param <R> Region concept (see 'Node').
+             * @param <E> Element concept (see 'Node').
+             * @param <P> Statistics policy (see 'Node').
+             */
+            template <typename K, typename R, typename E, typename P = NoStatistics> class DoubleBuffer {
+                public:
+                    typedef Node<K, R, E, P> Tree;
+                public:
+                    /**
+                     * Constructor.
+                     * The initial current tree is empty.
+                     * @param region Region covered by the trees.
+                     * @param cardinality Maximum number of elements per leaf.
+                     */
+                    DoubleBuffer(const R* region, unsigned int cardinality = DEFAULT_CARD);
+                    /**
+                     * Destructor. Waits for the pending build, if any, then
+                     * stops the builder.
+                     */
+                    ~DoubleBuffer();
+                    /**
+                     * Start building the next tree in background.
+                     * The element pointers are copied, but keys are read during the
+                     * build and must not change until 'wait' or 'swap' returns.
+                     * If a build is already running, wait for it first.
+                     * @param elements Element pool.
+                     * @param count Number of elements.
+                     */
+                    void rebuild(E** elements, unsigned int count);
+                    /**
+                     * @return 'true' if the next tree is built and can be swapped
+                     * without waiting.
+                     */
+                    bool ready() const;
+                    /**
+                     * Wait for the end of the pending build.
+                     */
+                    void wait();
+                    /**
+                     * Publish the next tree. Waits for its build if needed.
+                     * @return 'false' if there was no tree to publish.
+                     */
+                    bool swap();
+                    /**
+                     * Access the current tree. Thread-safe.
+                     * The returned tree stays valid as long as it is held, even
+                     * if other trees are published meanwhile.
+                     * @return Current tree.
+                     */
+                    std::shared_ptr<const Tree> current() const;
+
+                private:
+                    DoubleBuffer(const DoubleBuffer&);
+                    DoubleBuffer& operator=(const DoubleBuffer&);
+                    /**
+                     * Builder loop: sleep until a build is requested or the
+                     * buffer is destroyed.
+                     */
+                    void run();
+
+                private:
+                    /** Region covered by the trees. */
+                    const R*                    _region;
+                    /** Maximum number of elements per leaf. */
+                    unsigned int                _cardinality;
+                    /** Published tree. Only accessed through atomic operations. */
+                    std::shared_ptr<const Tree> _current;
+                    /** Tree being built. Owned by the builder until the build completes. */
+                    std::shared_ptr<const Tree> _next;
+                    /** Previously published tree, released by the next build. */
+                    std::shared_ptr<const Tree> _retired;
+                    /** Copy of the element pool, re-ordered by the build. */
+                    E**                         _scratch;
+                    /** Number of elements in the scratch buffer. */
+                    unsigned int                _size;
+                    /** Capacity of the scratch buffer. */
+                    unsigned int                _capacity;
+                    /** Build completion indicator. */
+                    std::atomic<bool>           _built;
+                    /** Guards the request and stop indicators. */
+                    std::mutex                  _mutex;
+                    /** Signals requests to the builder and completions to 'wait'. */
+                    std::condition_variable     _signal;
+                    /** 'true' from 'rebuild' to the end of the build. */
+                    bool                        _requested;
+                    /** 'true' when the builder must exit. */
+                    bool                        _stopped;
+                    /** Background builder, started at construction. */
+                    std::thread                 _builder;
+            };
+
+            template <typename K, typename R, typename E, typename P>
+                DoubleBuffer<K, R, E, P>::DoubleBuffer(const R* region, unsigned int cardinality) :
+                    _region(region), _cardinality(cardinality),
+                    _current(std::make_shared<const Tree>(region, cardinality)),
+                    _scratch(nullptr), _size(0), _capacity(0), _built(false),
+                    _requested(false), _stopped(false),
+                    _builder(&DoubleBuffer<K, R, E, P>::run, this) {
+                    }
+
+            template <typename K, typename R, typename E, typename P>
+                DoubleBuffer<K, R, E, P>::~DoubleBuffer() {
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _stopped = true;
+                    }
+                    _signal.notify_all();
+                    _builder.join();
+                    delete []_scratch;
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                void DoubleBuffer<K, R, E, P>::rebuild(E** elements, unsigned int count) {
+                    wait();
+                    if(count > _capacity) {
+                        delete []_scratch;
+                        _scratch = new E*[count];
+                        _capacity = count;
+                    }
+                    for(unsigned int i = 0; i < count; ++i) {
+                        _scratch[i] = elements[i];
+                    }
+                    _size = count;
+                    _built.store(false, std::memory_order_relaxed);
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _requested = true;
+                    }
+                    _signal.notify_all();
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                bool DoubleBuffer<K, R, E, P>::ready() const {
+                    return _built.load(std::memory_order_acquire);
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                void DoubleBuffer<K, R, E, P>::wait() {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _signal.wait(lock, [this] { return !_requested; });
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                bool DoubleBuffer<K, R, E, P>::swap() {
+                    wait();
+                    if(nullptr == _next) {
+                        return false;
+                    }
+                    // The old tree is kept aside so that its destruction,
+                    // when not delayed by readers, happens on the builder.
+                    _retired = std::atomic_exchange(&_current, _next);
+                    _next.reset();
+                    return true;
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                std::shared_ptr<const typename DoubleBuffer<K, R, E, P>::Tree>
+                DoubleBuffer<K, R, E, P>::current() const {
+                    return std::atomic_load(&_current);
+                }
+
+            template <typename K, typename R, typename E, typename P>
+                void DoubleBuffer<K, R, E, P>::run() {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    for(;;) {
+                        // A pending build is completed before stopping.
+                        _signal.wait(lock, [this] { return _requested || _stopped; });
+                        if(!_requested) {
+                            return;
+                        }
+                        lock.unlock();
+                        _retired.reset();
+                        std::shared_ptr<Tree> tree = std::make_shared<Tree>(_region, _cardinality);
+                        tree->build(_scratch, _size);
+                        _next = tree;
+                        lock.lock();
+                        _requested = false;
+                        _built.store(true, std::memory_order_release);
+                        _signal.notify_all();
+                    }
+                }
+
+        } // Namespace 'SearchTree'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif
@@ -0,0 +1,454 @@
+/*
+ * Copyright 2016 Stoned Xander
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HEADLESS_LOGIC_SEARCH_TREE_SNAPSHOT
+#define HEADLESS_LOGIC_SEARCH_TREE_SNAPSHOT
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+#include "searchtree.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HEADLESS_LOGIC_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGNMENT 16
+
+namespace Headless {
+    namespace Logic {
+        namespace SearchTree {
+
+            /**
+             * Persistent, read-only Search Tree.
+             *
+             * A snapshot is written once from a 'Node' and later memory-mapped and
+             * queried in place: no node is allocated and no element is re-inserted
+             * at load time. The only work done on load is the resolution of the
+             * element identifiers into element pointers.
+             *
+             * File layout (native endianness and alignment, all sections aligned
+             * on SNAPSHOT_ALIGNMENT bytes):
+             * - Header.
+             * - Nodes, in depth-first order. Each node records its region, the
+             *   size of its sub-tree (to skip it) and the range of its elements.
+             *   The elements of a sub-tree are contiguous.
+             * - Element keys.
+             * - Element identifiers.
+             *
+             * Keys are tested against the stored copy, so elements must not have
+             * moved since the snapshot was written.
+             *
+             * @param <K> Key concept (see 'Node'). Must be trivially copyable.
+             * @param <R> Region concept (see 'Node'). Must be trivially copyable.
+             * @param <E> Element concept (see 'Node').
+             */
+            template <typename K, typename R, typename E> class Snapshot {
+                public:
+                    /**
+                     * Constructor. The snapshot is empty until opened.
+                     */
+                    Snapshot();
+                    /**
+                     * Destructor.
+                     */
+                    ~Snapshot();
+                    /**
+                     * Write a tree in a file.
+                     * @param <M> Element mapping concept. Must implement:
+                     *     std::uint64_t id(const E*);
+                     * @param <P> Statistics policy of the tree.
+                     * @param path File path.
+                     * @param tree Tree to be written.
+                     * @param mapping Element mapping.
+                     * @return 'false' on I/O failure.
+                     */
+                    template <typename M, typename P> static bool write(const char* path,
+                            Node<K, R, E, P>& tree, M& mapping);
+                    /**
+                     * Map a snapshot file.
+                     * @param <M> Element mapping concept. Must implement:
+                     *     E* element(std::uint64_t);
+                     * @param path File path.
+                     * @param mapping Element mapping.
+                     * @return 'false' if the file cannot be read, has not been
+                     * written for these key and region types, or is truncated or
+                     * corrupt (sections out of the file, inconsistent records).
+                     */
+                    template <typename M> bool open(const char* path, M& mapping);
+                    /**
+                     * Unmap the snapshot.
+                     */
+                    void close();
+                    /**
+                     * @return Number of elements in the snapshot.
+                     */
+                    unsigned int size() const;
+                    /**
+                     * Retrieve elements. Same semantic as 'Node::retrieve'.
+                     * @param <S> Search function type (see 'Node::retrieve').
+                     * @param func Search function.
+                     * @param buffer Storage for eligible elements.
+                     * @param size Size of the buffer.
+                     * @return Number of eligible elements.
+                     */
+                    template <typename S> unsigned int retrieve(const S& func,
+                            E** buffer, unsigned int size) const;
+
+                private:
+                    /**
+                     * File header.
+                     */
+                    struct Header {
+                        char          magic[4];
+                        std::uint32_t version;
+                        std::uint32_t keySize;
+                        std::uint32_t recordSize;
+                        std::uint32_t nodeCount;
+                        std::uint32_t elementCount;
+                        std::uint64_t recordOffset;
+                        std::uint64_t keyOffset;
+                        std::uint64_t idOffset;
+                        std::uint64_t size;
+                    };
+
+                    /**
+                     * Node record.
+                     */
+                    struct Record {
+                        /** Region of the node. */
+                        R             region;
+                        /** Number of records in the sub-tree, this one included. */
+                        std::uint32_t skip;
+                        /** Number of sub-nodes. 0 for leaves. */
+                        std::uint32_t children;
+                        /** First element of the sub-tree. */
+                        std::uint32_t first;
+                        /** Past-the-end element of the sub-tree. */
+                        std::uint32_t last;
+                    };
+
+                    /**
+                     * Tree flattener.
+                     */
+                    template <typename M> class Writer {
+                        public:
+                            Writer(M& mapping) : _mapping(mapping) {}
+                            void enter(const R& region) {
+                                if(!_stack.empty()) {
+                                    ++_records[_stack.back()].children;
+                                }
+                                Record record;
+                                std::memset(static_cast<void*>(&record), 0, sizeof(Record));
+                                record.region = region;
+                                record.first = static_cast<std::uint32_t>(_keys.size());
+                                _stack.push_back(static_cast<std::uint32_t>(_records.size()));
+                                _records.push_back(record);
+                            }
+                            void exit(const R&) {
+                                Record& record = _records[_stack.back()];
+                                record.skip = static_cast<std::uint32_t>(_records.size() - _stack.back());
+                                record.last = static_cast<std::uint32_t>(_keys.size());
+                                _stack.pop_back();
+                            }
+                            void inspect(E** elements, unsigned int count) {
+                                for(unsigned int i = 0; i < count; ++i) {
+                                    _keys.push_back(elements[i]->key());
+                                    _ids.push_back(_mapping.id(elements[i]));
+                                }
+                            }
+                        public:
+                            M&                         _mapping;
+                            std::vector<std::uint32_t> _stack;
+                            std::vector<Record>        _records;
+                            std::vector<K>             _keys;
+                            std::vector<std::uint64_t> _ids;
+                    };
+
+                private:
+                    Snapshot(const Snapshot&);
+                    Snapshot& operator=(const Snapshot&);
+                    static std::uint64_t align(std::uint64_t offset);
+                    /**
+                     * @return 'true' if a section of 'count' items of 'size'
+                     * bytes at 'offset' is aligned and lies within the file
+                     * content, after the header.
+                     */
+                    bool fits(std::uint64_t offset, std::uint64_t count, std::uint64_t size) const;
+                    /**
+                     * @return 'true' if the records describe a tree: each sub-tree
+                     * lies within its parent, made of its children sub-trees,
+                     * and its elements within the element section.
+                     */
+                    bool valid(const Header* header) const;
+
+                private:
+                    /** Mapped (or loaded) file content. */
+                    char*               _data;
+                    /** Size of the file content. */
+                    std::uint64_t       _length;
+                    /** Memory-mapped indicator. */
+                    bool                _mapped;
+                    /** Node records. */
+                    const Record*       _records;
+                    /** Element keys. */
+                    const K*            _keys;
+                    /** Resolved elements. */
+                    E**                 _elements;
+                    /** Number of elements. */
+                    unsigned int        _count;
+            };
+
+            template <typename K, typename R, typename E>
+                Snapshot<K, R, E>::Snapshot() : _data(nullptr), _length(0), _mapped(false),
+                    _records(nullptr), _keys(nullptr), _elements(nullptr), _count(0) {
+                        static_assert(std::is_trivially_copyable<K>::value,
+                                "Snapshot keys must be trivially copyable.");
+                        static_assert(std::is_trivially_copyable<R>::value,
+                                "Snapshot regions must be trivially copyable.");
+                    }
+
+            template <typename K, typename R, typename E>
+                Snapshot<K, R, E>::~Snapshot() {
+                    close();
+                }
+
+            template <typename K, typename R, typename E>
+                std::uint64_t Snapshot<K, R, E>::align(std::uint64_t offset) {
+                    return (offset + SNAPSHOT_ALIGNMENT - 1) & ~static_cast<std::uint64_t>(SNAPSHOT_ALIGNMENT - 1);
+                }
+
+            template <typename K, typename R, typename E>
+                bool Snapshot<K, R, E>::fits(std::uint64_t offset, std::uint64_t count,
+                        std::uint64_t size) const {
+                    return offset >= sizeof(Header) && offset <= _length &&
+                        0 == offset % SNAPSHOT_ALIGNMENT &&
+                        count <= (_length - offset) / size;
+                }
+
+            template <typename K, typename R, typename E>
+                bool Snapshot<K, R, E>::valid(const Header* header) const {
+                    if(_records[0].skip != header->nodeCount) {
+                        return false;
+                    }
+                    for(std::uint32_t i = 0; i < header->nodeCount; ++i) {
+                        const Record& record = _records[i];
+                        if(record.skip < 1 || record.skip > header->nodeCount - i ||
+                                record.first > record.last || record.last > header->elementCount) {
+                            return false;
+                        }
+                        // Children follow their parent, one sub-tree after the other.
+                        std::uint64_t child = i + 1;
+                        std::uint64_t end = i + record.skip;
+                        for(std::uint32_t c = 0; c < record.children; ++c) {
+                            if(child >= end) {
+                                return false;
+                            }
+                            child += _records[child].skip;
+                        }
+                        if(child != (record.children == 0 ? i + 1 : end) ||
+                                (record.children == 0 && record.skip != 1)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+
+            template <typename K, typename R, typename E>
+                template <typename M, typename P>
+                bool Snapshot<K, R, E>::write(const char* path, Node<K, R, E, P>& tree, M& mapping) {
+                    Writer<M> writer(mapping);
+                    tree.visit(writer);
+
+                    Header header;
+                    std::memset(&header, 0, sizeof(Header));
+                    std::memcpy(header.magic, "HLST", 4);
+                    header.version = SNAPSHOT_VERSION;
+                    header.keySize = sizeof(K);
+                    header.recordSize = sizeof(Record);
+                    header.nodeCount = static_cast<std::uint32_t>(writer._records.size());
+                    header.elementCount = static_cast<std::uint32_t>(writer._keys.size());
+                    header.recordOffset = align(sizeof(Header));
+                    header.keyOffset = align(header.recordOffset + header.nodeCount * sizeof(Record));
+                    header.idOffset = align(header.keyOffset + header.elementCount * sizeof(K));
+                    header.size = header.idOffset + header.elementCount * sizeof(std::uint64_t);
+
+                    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                    static const char padding[SNAPSHOT_ALIGNMENT] = { 0 };
+                    std::uint64_t offset = sizeof(Header);
+                    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+                    out.write(padding, header.recordOffset - offset);
+                    out.write(reinterpret_cast<const char*>(writer._records.data()),
+                            header.nodeCount * sizeof(Record));
+                    offset = header.recordOffset + header.nodeCount * sizeof(Record);
+                    out.write(padding, header.keyOffset - offset);
+                    out.write(reinterpret_cast<const char*>(writer._keys.data()),
+                            header.elementCount * sizeof(K));
+                    offset = header.keyOffset + header.elementCount * sizeof(K);
+                    out.write(padding, header.idOffset - offset);
+                    out.write(reinterpret_cast<const char*>(writer._ids.data()),
+                            header.elementCount * sizeof(std::uint64_t));
+                    out.close();
+                    return !out.fail();
+                }
+
+            template <typename K, typename R, typename E>
+                template <typename M>
+                bool Snapshot<K, R, E>::open(const char* path, M& mapping) {
+                    close();
+#ifdef HEADLESS_LOGIC_SNAPSHOT_MMAP
+                    int fd = ::open(path, O_RDONLY);
+                    if(fd < 0) {
+                        return false;
+                    }
+                    struct stat status;
+                    if(fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(Header))) {
+                        ::close(fd);
+                        return false;
+                    }
+                    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    ::close(fd);
+                    if(MAP_FAILED == data) {
+                        return false;
+                    }
+                    _data = static_cast<char*>(data);
+                    _length = status.st_size;
+                    _mapped = true;
+#else
+                    std::ifstream in(path, std::ios::binary | std::ios::ate);
+                    if(!in) {
+                        return false;
+                    }
+                    _length = static_cast<std::uint64_t>(in.tellg());
+                    in.seekg(0);
+                    _data = new char[_length];
+                    in.read(_data, _length);
+                    if(!in || _length < sizeof(Header)) {
+                        close();
+                        return false;
+                    }
+#endif
+                    const Header* header = reinterpret_cast<const Header*>(_data);
+                    if(std::memcmp(header->magic, "HLST", 4) != 0 ||
+                            header->version != SNAPSHOT_VERSION ||
+                            header->keySize != sizeof(K) ||
+                            header->recordSize != sizeof(Record) ||
+                            header->nodeCount == 0 ||
+                            header->size > _length ||
+                            !fits(header->recordOffset, header->nodeCount, sizeof(Record)) ||
+                            !fits(header->keyOffset, header->elementCount, sizeof(K)) ||
+                            !fits(header->idOffset, header->elementCount, sizeof(std::uint64_t))) {
+                        close();
+                        return false;
+                    }
+                    _records = reinterpret_cast<const Record*>(_data + header->recordOffset);
+                    if(!valid(header)) {
+                        close();
+                        return false;
+                    }
+                    _keys = reinterpret_cast<const K*>(_data + header->keyOffset);
+                    _count = header->elementCount;
+                    const std::uint64_t* ids = reinterpret_cast<const std::uint64_t*>(_data + header->idOffset);
+                    _elements = new E*[_count];
+                    for(unsigned int i = 0; i < _count; ++i) {
+                        _elements[i] = mapping.element(ids[i]);
+                    }
+                    return true;
+                }
+
+            template <typename K, typename R, typename E>
+                void Snapshot<K, R, E>::close() {
+                    if(nullptr != _data) {
+#ifdef HEADLESS_LOGIC_SNAPSHOT_MMAP
+                        if(_mapped) {
+                            munmap(_data, _length);
+                        }
+#endif
+                        if(!_mapped) {
+                            delete []_data;
+                        }
+                    }
+                    delete []_elements;
+                    _data = nullptr;
+                    _length = 0;
+                    _mapped = false;
+                    _records = nullptr;
+                    _keys = nullptr;
+                    _elements = nullptr;
+                    _count = 0;
+                }
+
+            template <typename K, typename R, typename E>
+                unsigned int Snapshot<K, R, E>::size() const {
+                    return _count;
+                }
+
+            template <typename K, typename R, typename E>
+                template <typename S>
+                unsigned int Snapshot<K, R, E>::retrieve(const S& func, E** buffer, unsigned int size) const {
+                    if(nullptr == _records) {
+                        return 0;
+                    }
+                    E** dest = buffer;
+                    unsigned int remaining = size;
+                    // As for 'Node::retrieve', the root region is not tested.
+                    unsigned int current = _records[0].children == 0 ? 0 : 1;
+                    unsigned int end = _records[0].skip;
+                    while(current < end && remaining > 0) {
+                        const Record& record = _records[current];
+                        int intersects = current == 0 ? 0 : func.contains(record.region);
+                        if(intersects < 0) {
+                            current += record.skip;
+                        } else if(intersects > 0) {
+                            // Fully contained: the sub-tree elements are contiguous.
+                            unsigned int count = record.last - record.first;
+                            count = count < remaining ? count : remaining;
+                            E* const* src = _elements + record.first;
+                            for(unsigned int i = 0; i < count; ++i) {
+                                dest[i] = src[i];
+                            }
+                            dest += count;
+                            remaining -= count;
+                            current += record.skip;
+                        } else if(record.children == 0) {
+                            const K* key = _keys + record.first;
+                            for(unsigned int i = record.first; i < record.last && remaining > 0; ++i, ++key) {
+                                if(func.contains(*key)) {
+                                    *dest = _elements[i];
+                                    ++dest;
+                                    --remaining;
+                                }
+                            }
+                            current += record.skip;
+                        } else {
+                            // Partial overlap: descend.
+                            ++current;
+                        }
+                    }
+                    return size - remaining;
+                }
+
+        } // Namespace 'SearchTree'
+    } // Namespace 'Logic'
+} // Namespace 'Headless'
+
+#endif